@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Compare two sets of benchmark results and fail on regressions.
+
+Each side is a result file or a directory searched for `*.bench.json`,
+`*.superopt.bench.json` included. Result files are either Hyperfine exports
+(as saved by `turnt -e bench` and `turnt -e bench-superopt`) or the `--json`
+output of `bril-bench`, whose engines are the `superopt-*` modes of the same
+name. For every benchmark and mode present on both sides, the ratio of
+median run times (candidate / baseline) gets a bootstrap confidence
+interval. A benchmark regresses when the whole interval lies above
+1 + threshold, and improves when it lies below 1 - threshold.
+
+    python3 compare.py [--threshold=0.05] [--confidence=0.95] BASELINE CANDIDATE
+
+Writes a CSV row per comparison to stdout and a summary to stderr. Exits
+with status 1 if anything regressed.
+"""
+import argparse
+import csv
+import json
+import os
+import random
+import re
+import statistics
+import sys
+from collections import defaultdict
+
+# Checked in order: the superopt modes come before plain `brili`.
+MODES = {
+    'superopt-jit': r'bril-superopt/\S*brili --jit\b',
+    'superopt-tiered': r'bril-superopt/\S*brili --tiered\b',
+    'superopt-trace': r'bril-superopt/\S*brili --trace\b',
+    'superopt-interp': r'bril-superopt/\S*brili\b',
+    'fastbrili': r'\bfastbrili\b',
+    'brili': r'\bbrili\b',
+    'brilirs': r'\bbrilirs\b',
+    'brilift-jit': r'\bbrilift -j',
+    'brilift-aot': r'^\./[^/]+ ',
+}
+RESAMPLES = 2000
+
+
+def result_files(path):
+    if not os.path.isdir(path):
+        yield path
+        return
+    for root, _, files in os.walk(path):
+        for fn in sorted(files):
+            if fn.endswith('.bench.json'):  # and .superopt.bench.json
+                yield os.path.join(root, fn)
+
+
+def get_samples(path):
+    """Map (bench, mode) to the run times in seconds."""
+    samples = {}
+    for fn in result_files(path):
+        with open(fn) as f:
+            bench_data = json.load(f)
+
+        for res in bench_data['results']:
+            if 'engine' in res:  # bril-bench
+                mode = 'superopt-' + res['engine']
+                samples[res['bench'], mode] = [t / 1e9 for t in res['times_ns']]
+                continue
+            bench, _ = os.path.basename(fn).split('.', 1)
+            for mode, pat in MODES.items():
+                if re.search(pat, res['command']):
+                    break
+            else:
+                assert False, "unknown benchmark command"
+            samples[bench, mode] = res['times']
+    return samples
+
+
+def bootstrap(base, cand, confidence, rng):
+    """Confidence interval of median(cand) / median(base)."""
+    ratios = []
+    for _ in range(RESAMPLES):
+        b = statistics.median(rng.choices(base, k=len(base)))
+        c = statistics.median(rng.choices(cand, k=len(cand)))
+        ratios.append(c / b)
+    ratios.sort()
+    tail = (1 - confidence) / 2
+    lo = ratios[int(tail * (RESAMPLES - 1))]
+    hi = ratios[int((1 - tail) * (RESAMPLES - 1))]
+    return lo, hi
+
+
+def compare(baseline, candidate, threshold, confidence):
+    base = get_samples(baseline)
+    cand = get_samples(candidate)
+    rng = random.Random(0)  # the same verdicts for the same inputs
+
+    writer = csv.DictWriter(
+        sys.stdout,
+        ['bench', 'mode', 'baseline', 'candidate', 'ratio', 'ci_low',
+         'ci_high', 'verdict'],
+    )
+    writer.writeheader()
+    ratios = defaultdict(list)
+    regressions = []
+    for key in sorted(base.keys() & cand.keys()):
+        bench, mode = key
+        b, c = base[key], cand[key]
+        ratio = statistics.median(c) / statistics.median(b)
+        lo, hi = bootstrap(b, c, confidence, rng)
+        if lo > 1 + threshold:
+            verdict = 'regression'
+            regressions.append(key)
+        elif hi < 1 - threshold:
+            verdict = 'improvement'
+        else:
+            verdict = 'same'
+        ratios[mode].append(ratio)
+
+        writer.writerow({
+            'bench': bench,
+            'mode': mode,
+            'baseline': statistics.median(b),
+            'candidate': statistics.median(c),
+            'ratio': ratio,
+            'ci_low': lo,
+            'ci_high': hi,
+            'verdict': verdict,
+        })
+
+    for key in sorted(base.keys() ^ cand.keys()):
+        print('{} {}: only in {}'.format(
+            *key, 'baseline' if key in base else 'candidate'
+        ), file=sys.stderr)
+    for mode, ratio_list in ratios.items():
+        print('{}: {:.3f}x time'.format(
+            mode,
+            statistics.geometric_mean(ratio_list)
+        ), file=sys.stderr)
+    for bench, mode in regressions:
+        print('regression: {} {}'.format(bench, mode), file=sys.stderr)
+    return not regressions
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(
+        description='Compare benchmark results and fail on regressions.'
+    )
+    parser.add_argument('baseline')
+    parser.add_argument('candidate')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='tolerated slowdown, as a fraction')
+    parser.add_argument('--confidence', type=float, default=0.95,
+                        help='confidence level of the intervals')
+    args = parser.parse_args()
+    ok = compare(args.baseline, args.candidate, args.threshold,
+                 args.confidence)
+    sys.exit(0 if ok else 1)
@@ -0,0 +1,25 @@
+#ifndef ANALYSIS_CFG_H
+#define ANALYSIS_CFG_H
+
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace opt {
+
+using PredMap = std::unordered_map<const ir::BasicBlock*, std::vector<ir::BasicBlock*>>;
+
+// CFG predecessors of every block of 'func'
+PredMap Predecessors(const ir::Function& func);
+
+// blocks reachable from the entry, in reverse post-order
+std::vector<ir::BasicBlock*> ReversePostOrder(const ir::Function& func);
+
+// the owning pointer of 'bb' in 'func', nullptr if it is not there
+ir::BBPtr FindBlock(const ir::Function& func, const ir::BasicBlock* bb);
+
+}  // namespace opt
+
+#endif  // ANALYSIS_CFG_H
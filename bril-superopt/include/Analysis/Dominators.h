@@ -0,0 +1,27 @@
+#ifndef ANALYSIS_DOMINATORS_H
+#define ANALYSIS_DOMINATORS_H
+
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+
+#include <unordered_map>
+
+namespace opt {
+
+// immediate dominators of the blocks reachable from the entry
+class DominatorTree {
+   public:
+    DominatorTree(const ir::Function& func);
+    ~DominatorTree() = default;
+    // nullptr for the entry block and for unreachable blocks
+    const ir::BasicBlock* idom(const ir::BasicBlock* bb) const;
+    bool dominates(const ir::BasicBlock* a, const ir::BasicBlock* b) const;
+    bool reachable(const ir::BasicBlock* bb) const;
+
+   private:
+    std::unordered_map<const ir::BasicBlock*, const ir::BasicBlock*> idoms;
+};
+
+}  // namespace opt
+
+#endif  // ANALYSIS_DOMINATORS_H
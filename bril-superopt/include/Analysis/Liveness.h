@@ -0,0 +1,32 @@
+#ifndef ANALYSIS_LIVENESS_H
+#define ANALYSIS_LIVENESS_H
+
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace opt {
+
+using VarSet = std::unordered_set<std::string>;
+
+// live variables (by name) at the entry and exit of every basic block
+class Liveness {
+   public:
+    Liveness(const ir::Function& func);
+    ~Liveness() = default;
+    const VarSet& liveIn(const ir::BasicBlock* bb) const;
+    const VarSet& liveOut(const ir::BasicBlock* bb) const;
+
+   private:
+    std::unordered_map<const ir::BasicBlock*, VarSet> in, out;
+};
+
+// update 'live' backwards across one instruction
+void StepLiveness(const ir::Instruction& instr, VarSet& live);
+
+}  // namespace opt
+
+#endif  // ANALYSIS_LIVENESS_H
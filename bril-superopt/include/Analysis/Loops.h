@@ -0,0 +1,51 @@
+#ifndef ANALYSIS_LOOPS_H
+#define ANALYSIS_LOOPS_H
+
+#include <Analysis/Dominators.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+// natural loop: all back edges into 'header' merged into one loop
+struct Loop {
+    ir::BasicBlock* header;
+    std::unordered_set<const ir::BasicBlock*> blocks;
+    std::vector<ir::BasicBlock*> latches;  // sources of the back edges
+    Loop* parent = nullptr;
+    std::vector<Loop*> children;
+
+    bool contains(const ir::BasicBlock* bb) const { return blocks.contains(bb); }
+    // blocks outside the loop that are targets of edges leaving it
+    std::vector<ir::BasicBlock*> exitBlocks() const;
+};
+
+// the loop forest of a function
+class LoopInfo {
+   public:
+    LoopInfo(const ir::Function& func, const DominatorTree& domTree);
+    ~LoopInfo() = default;
+    const std::vector<Loop*>& topLevel() const { return roots; }
+    // every loop, inner loops before the loops containing them
+    std::vector<Loop*> postOrder() const;
+    // innermost loop containing 'bb', nullptr if none
+    Loop* loopFor(const ir::BasicBlock* bb) const;
+
+   private:
+    std::vector<std::unique_ptr<Loop>> loops;
+    std::vector<Loop*> roots;
+    std::unordered_map<const ir::BasicBlock*, Loop*> innermost;
+};
+
+// set BasicBlock::loopHeader and loopLatch, which the interpreter uses to
+// count back edges for tiering and tracing
+void MarkLoops(ir::Function& func);
+
+}  // namespace opt
+
+#endif  // ANALYSIS_LOOPS_H
@@ -0,0 +1,38 @@
+#ifndef ANALYSIS_POINTSTO_H
+#define ANALYSIS_POINTSTO_H
+
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace opt {
+
+// Flow-insensitive points-to over the 'alloc' sites of one function. Pointers
+// that come from arguments, loads or calls point to UnknownSite.
+class PointsTo {
+   public:
+    static constexpr int UnknownSite = -1;
+
+    std::vector<std::shared_ptr<ir::Alloc>> sites;
+
+    PointsTo(const ir::Function& func);
+    ~PointsTo() = default;
+    // site indices 'var' may point to, UnknownSite included
+    const std::set<int>& pointees(const std::string& var) const;
+    // the pointer leaves the function through a call, 'ret' or 'store'
+    bool escapes(int site) const;
+    bool mayAlias(const std::string& lhs, const std::string& rhs) const;
+
+   private:
+    std::unordered_map<std::string, std::set<int>> pts;
+    std::vector<bool> escaped;
+};
+
+}  // namespace opt
+
+#endif  // ANALYSIS_POINTSTO_H
@@ -0,0 +1,36 @@
+#ifndef ANALYSIS_PROFILE_H
+#define ANALYSIS_PROFILE_H
+
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace opt {
+
+// Call-site profile: {"call_sites": {"<func>": [<hits of the i-th call>, ...]}}
+// with calls numbered in layout order. Written by 'brili --call-profile-out=<file>'
+// from the block counts of a run under the counting interpreter
+// (Function::counting), read back into Call::hits before any pass reorders the
+// program. Only valid for the call sites as written: see CallSites().
+void WriteCallProfile(const ir::Program& prog, std::ostream& os);
+void ReadCallProfile(ir::Program& prog, std::istream& is);
+// the calls of 'prog' in profile order; a pass that inlines, clones or removes
+// one leaves a different list
+std::vector<std::shared_ptr<ir::Call>> CallSites(const ir::Program& prog);
+
+// Block profile of a run under the counting interpreter (Function::counting):
+// {"blocks": {"<func>": [{"block": ".<label>", "runs": N, "instrs": <per run>,
+//   "taken": {"to": ".<label>", "count": N}, "not_taken": {...}}, ...]}}
+// with blocks in layout order and an edge only where the successor exists.
+void WriteBlockProfile(const ir::Program& prog, std::ostream& os);
+// The same as folded stacks for flame graph tools, one "@<func>;.<label> N"
+// line per executed block, N its dynamic instructions.
+void WriteFoldedProfile(const ir::Program& prog, std::ostream& os);
+
+}  // namespace opt
+
+#endif  // ANALYSIS_PROFILE_H
@@ -0,0 +1,20 @@
+#ifndef ANALYSIS_PURITY_H
+#define ANALYSIS_PURITY_H
+
+#include <IR/Function.h>
+#include <IR/Program.h>
+
+#include <unordered_set>
+
+namespace opt {
+
+// Functions whose result depends on nothing but their argument values and
+// that have no visible effect: no 'print', 'alloc', 'free', 'store' or
+// 'load' (the heap may change between calls) and only pure callees. They may
+// still fail or not terminate. Computed as a greatest fixed point, so
+// recursive functions can be pure.
+std::unordered_set<const ir::Function*> PureFunctions(const ir::Program& prog);
+
+}  // namespace opt
+
+#endif  // ANALYSIS_PURITY_H
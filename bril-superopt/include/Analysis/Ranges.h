@@ -0,0 +1,19 @@
+#ifndef ANALYSIS_RANGES_H
+#define ANALYSIS_RANGES_H
+
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+
+#include <unordered_set>
+
+namespace opt {
+
+// Loads and stores of 'func' that provably access a live allocation made in
+// 'func', at an element offset within [0, size). Offsets are tracked through
+// 'ptradd' chains as intervals whose upper bound may be symbolic (i <= n - 1),
+// refined by the compares that guard loops over induction variables.
+std::unordered_set<const ir::Instruction*> SafeAccesses(const ir::Function& func);
+
+}  // namespace opt
+
+#endif  // ANALYSIS_RANGES_H
@@ -0,0 +1,18 @@
+#ifndef CODEGEN_CPPEMITTER_H
+#define CODEGEN_CPPEMITTER_H
+
+#include <IR/Program.h>
+
+#include <ostream>
+
+namespace codegen {
+
+// Write 'prog' as one self-contained C++ translation unit: every function
+// becomes a C++ function, blocks become labels reached by goto, variables
+// become typed locals and the heap is a small checked runtime at the top of
+// the file. Output and error messages follow brili.
+void EmitCpp(ir::Program& prog, std::ostream& os);
+
+}  // namespace codegen
+
+#endif  // CODEGEN_CPPEMITTER_H
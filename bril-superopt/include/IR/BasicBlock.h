@@ -20,6 +20,11 @@ class BasicBlock {
     // jmp: taken; fall-through: notTaken
     BBWPtr taken, notTaken;
     std::vector<InstPtr> instrs;
+    // loop structure, marked by a tiering engine to count back edges
+    bool loopHeader = false, loopLatch = false;
+    // executions and successors taken, counted by the counting interpreter
+    // (see Function::counting); a block left by ret counts no edge
+    uint64_t runs = 0, takenRuns = 0, notTakenRuns = 0;
 
     BasicBlock() = default;
     BasicBlock(std::vector<InstPtr>&& instrs);
@@ -28,6 +33,7 @@ class BasicBlock {
     ctrlStatus execute(varContext& vars, HeapManager& heap);
     std::vector<Variable> liveIn();
     std::vector<Variable> liveOut();
+    std::vector<BBPtr> successors() const;
 
    private:
 };
@@ -0,0 +1,39 @@
+#ifndef IR_DYNCOUNT_H
+#define IR_DYNCOUNT_H
+
+#include <IR/BasicBlock.h>
+#include <IR/Program.h>
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ir {
+
+// Dynamic instruction counts of a run under the counting interpreter (see
+// Function::counting), as the reference brili -p reports them. Only block
+// executions are counted; the instructions are attributed from the block
+// contents, a superinstruction counting as its two halves and labels as none.
+class DynCount {
+   public:
+    uint64_t total = 0;
+    std::map<std::string, uint64_t> byOpcode;
+    std::vector<std::pair<std::string, uint64_t>> byFunction;  // in program order
+
+    DynCount(const Program& prog);
+    ~DynCount() = default;
+    // total_dyn_inst: N
+    void report(std::ostream& os) const;
+    // per-opcode and per-function counts, most frequent first
+    void histogram(std::ostream& os) const;
+};
+
+// instructions one execution of 'bb' counts
+uint64_t InstructionCount(const BasicBlock& bb);
+
+}  // namespace ir
+
+#endif  // IR_DYNCOUNT_H
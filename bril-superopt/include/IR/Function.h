@@ -4,8 +4,12 @@
 #include <IR/BasicBlock.h>
 #include <IR/Heap.h>
 #include <IR/Instruction.h>
+#include <IR/Memo.h>
+#include <IR/OpcodePairs.h>
+#include <IR/Sampler.h>
 #include <IR/Type.h>
 
+#include <functional>
 #include <memory>
 #include <nlohmann/json_fwd.hpp>
 #include <string>
@@ -15,19 +19,72 @@ using json = nlohmann::json;
 
 namespace ir {
 
+class Function;
+
+// Lets a tiering engine (see JIT/Tiering.h) watch the interpreter:
+// Function::execute counts invocations and back edges and asks for a
+// promotion when a counter reaches its threshold (0 never does).
+class TierHook {
+   public:
+    uint64_t callThreshold = 0, backEdgeThreshold = 0;
+
+    virtual ~TierHook() = default;
+    // compile 'func' and install Function::native; false if it stays interpreted
+    virtual bool promote(Function& func) = 0;
+    // on-stack replacement: finish the running activation of compiled 'func'
+    // natively from loop header 'header'; false if it cannot be entered there
+    virtual bool enterLoop([[maybe_unused]] Function& func, [[maybe_unused]] BasicBlock& header, [[maybe_unused]] varContext& vars,
+                           [[maybe_unused]] HeapManager& heap, [[maybe_unused]] std::optional<int64_t>& ret) {
+        return false;
+    }
+};
+
+// Lets a tracing engine (see Trace/Tracer.h) follow the interpreter from
+// block to block: Function::execute reports every transition, and the engine
+// may run recorded traces from there. It returns the block to continue at.
+class TraceHook {
+   public:
+    virtual ~TraceHook() = default;
+    virtual BBPtr transition(Function& func, BasicBlock& from, BBPtr to, varContext& vars, HeapManager& heap) = 0;
+};
+
+using NativeEntry = std::function<std::optional<int64_t>(varContext& vars, HeapManager& heap)>;
+
 class Function {
    public:
     std::string name;
     std::vector<VarPtr> args;
     std::vector<BBPtr> basicBlocks;
+    // tiering state: hotness counters, the engine and the compiled entry
+    uint64_t calls = 0, backEdges = 0;
+    TierHook* tier = nullptr;
+    NativeEntry native;
+    MemoTable* memo = nullptr;  // caches results by argument values; only for pure functions
+    OpcodePairs* pairs = nullptr;  // records every block entry when profiling
+    TraceHook* tracer = nullptr;
+    bool counting = false;  // run the interpreter that counts block executions and edges (see IR/DynCount.h)
+    Sampler* sampler = nullptr;  // run the interpreter that publishes every instruction before executing it
 
     Function(const json& funcJson);
     ~Function() = default;
     friend std::ostream& operator<<(std::ostream& os, const Function& func);
     void ConstructCFG(std::vector<InstPtr>& instrs);
+    void MarkTailCalls();
     std::optional<int64_t> execute(varContext& vars, HeapManager& heap);
+    BBPtr getEntry() const { return entryBB; }
+    void setEntry(BBPtr bb) { entryBB = std::move(bb); }
+    TypePtr getRetType() const { return retType; }
+    // the block's label, or #<index> for an unlabeled block
+    std::string blockName(const BasicBlock& bb) const;
 
    private:
+    // count an invocation; true when it should run the compiled code
+    bool enterTier();
+    // the interpreter loop; the counting instance also bumps the block and edge
+    // counters of BasicBlock, the sampling one keeps Sampler::current up to date
+    template <bool Counting, bool Sampling>
+    std::optional<int64_t> interpret(varContext& vars, HeapManager& heap);
+
     BBPtr entryBB = nullptr;
     TypePtr retType = nullptr;
 };
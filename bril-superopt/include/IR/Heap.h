@@ -10,13 +10,20 @@ namespace ir {
 class HeapManager {
    public:
     HeapManager() = default;
-    ~HeapManager() = default;
+    // frees what the program leaked, so that repeated runs do not pile it up
+    ~HeapManager();
+    HeapManager(const HeapManager &) = delete;
+    HeapManager &operator=(const HeapManager &) = delete;
+    // 'size' words, all 0
     int64_t *allocate(int size);
     void deallocate(int64_t *ptr);
     bool boundCheck(int64_t *ptr);
+    // most words allocated and not yet freed at any one time
+    uint64_t peak() const { return peakWords; }
 
    private:
     std::map<int64_t *, int> heap;
+    uint64_t liveWords = 0, peakWords = 0;
 };
 
 }  // namespace ir
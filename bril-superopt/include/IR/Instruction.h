@@ -4,6 +4,7 @@
 #include <IR/Heap.h>
 #include <IR/Type.h>
 
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <optional>
@@ -16,19 +17,37 @@ namespace ir {
 
 class Instruction;
 using InstPtr = std::shared_ptr<Instruction>;
+using Renamer = std::function<std::string(const std::string&)>;
 
 std::ostream& operator<<(std::ostream& os, const Instruction& instr);
 
-// union of {return value} and {branch taken/not taken}
+// where print writes on this thread: std::cout unless redirected, as
+// bril-diff does to capture the output of each engine
+std::ostream& Output();
+// nullptr goes back to std::cout
+void SetOutput(std::ostream* os);
+
+class Call;
+
+// union of {return value}, {branch taken/not taken} and {call in tail position}
 class ctrlStatus {
    public:
     ctrlStatus(std::optional<int64_t> ret) : status(ret) {}
     ctrlStatus(bool taken) : status(taken) {}
+    ctrlStatus(const Call* tailCall) : status(tailCall) {}
 
     bool retValid() const {
         return std::holds_alternative<std::optional<int64_t>>(status);
     }
 
+    bool tailCallValid() const {
+        return std::holds_alternative<const Call*>(status);
+    }
+
+    const Call* getTailCall() const {
+        return std::get<const Call*>(status);
+    }
+
     std::optional<int64_t> getRet() const {
         return std::get<std::optional<int64_t>>(status);
     }
@@ -45,7 +64,7 @@ class ctrlStatus {
     }
 
    private:
-    std::variant<std::optional<int64_t>, bool> status;
+    std::variant<std::optional<int64_t>, bool, const Call*> status;
 };
 
 class Instruction {
@@ -54,8 +73,15 @@ class Instruction {
     virtual ~Instruction() = default;
     virtual std::ostream& print(std::ostream& os) const = 0;
     virtual bool isTerminator() const { return false; }
+    // no side effect and cannot fail: safe to delete when dead or to hoist
+    virtual bool isPure() const { return false; }
     virtual std::vector<Variable> liveIn() { return {}; }
     virtual std::vector<Variable> liveOut() { return {}; }
+    // variable names read/written, including operands whose type is not recorded
+    virtual std::vector<std::string> uses() const { return {}; }
+    virtual std::vector<std::string> defs() const { return {}; }
+    // copy with variable and label names mapped through 'var' and 'label'
+    virtual InstPtr clone(const Renamer& var, const Renamer& label) const = 0;
 
     // return int64_t only when it's 'ret'
     virtual ctrlStatus execute([[maybe_unused]] varContext& vars, [[maybe_unused]] HeapManager& heap) {
@@ -77,21 +103,26 @@ class Label : public Instruction {
     Label(std::string name) : name(name) {}
     ~Label() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
 
    private:
 };
 
 class Constant : public CoreComputeInst {
    public:
+    VarPtr dest;
+    int64_t val;
+
     Constant(VarPtr dest, int64_t val) : dest(dest), val(val) {}
     ~Constant() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
+    bool isPure() const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
     std::vector<Variable> liveOut() override;
+    std::vector<std::string> defs() const override;
 
    private:
-    VarPtr dest;
-    int64_t val;
 };
 
 enum BinaryOpType {
@@ -111,17 +142,22 @@ enum BinaryOpType {
 
 class BinaryOp : public CoreComputeInst {
    public:
+    VarPtr dest;
+    BinaryOpType op;
+    VarPtr lhs, rhs;
+
     BinaryOp(BinaryOpType op, VarPtr dest, VarPtr lhs, VarPtr rhs) : dest(dest), op(op), lhs(lhs), rhs(rhs) {}
     ~BinaryOp() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
+    bool isPure() const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
     std::vector<Variable> liveIn() override;
     std::vector<Variable> liveOut() override;
+    std::vector<std::string> uses() const override;
+    std::vector<std::string> defs() const override;
 
    private:
-    VarPtr dest;
-    BinaryOpType op;
-    VarPtr lhs, rhs;
 };
 
 enum UnaryOpType {
@@ -131,15 +167,21 @@ enum UnaryOpType {
 
 class UnaryOp : public CoreComputeInst {
    public:
+    VarPtr dest;
+    UnaryOpType op;
+    VarPtr src;
+
     UnaryOp(UnaryOpType op, VarPtr dest, VarPtr src) : dest(dest), op(op), src(src) {}
     ~UnaryOp() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
+    bool isPure() const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<Variable> liveOut() override;
+    std::vector<std::string> uses() const override;
+    std::vector<std::string> defs() const override;
 
    private:
-    VarPtr dest;
-    UnaryOpType op;
-    VarPtr src;
 };
 
 class Jump : public Instruction {
@@ -149,6 +191,7 @@ class Jump : public Instruction {
     Jump(std::string target) : target(target) {}
     ~Jump() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     bool isTerminator() const override;
     ctrlStatus execute([[maybe_unused]] varContext& vars, [[maybe_unused]] HeapManager& heap) override;
 
@@ -163,9 +206,11 @@ class Branch : public Instruction {
     Branch(VarPtr cond, std::string ifTrue, std::string ifFalse) : cond(cond), ifTrue(ifTrue), ifFalse(ifFalse) {}
     ~Branch() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     bool isTerminator() const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
     std::vector<Variable> liveIn() override;
+    std::vector<std::string> uses() const override;
 
    private:
 };
@@ -174,6 +219,9 @@ class Branch : public Instruction {
 class Function;
 using FuncWPtr = std::weak_ptr<Function>;
 
+// A call whose result is returned right away is executed by the calling
+// Function::execute loop in place of its own frame ('tail'), which keeps the
+// host stack flat for tail recursion, mutual recursion included.
 class Call : public Instruction {
    public:
     const VarPtr dest;  // might be nullptr
@@ -181,51 +229,70 @@ class Call : public Instruction {
     FuncWPtr func;
     const std::vector<std::string> args;
     std::vector<VarPtr> argsVar;
+    uint64_t hits = 0;  // the count loaded from a call profile, 0 in copies
+    bool tail = false;  // set by Function::MarkTailCalls
 
     Call(VarPtr dest, std::string funcName, std::vector<std::string> args) : dest(dest), funcName(std::move(funcName)), args(std::move(args)) {}
     ~Call() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    // the callee frame holding the argument values read from 'vars'
+    varContext bindArgs(varContext& vars) const;
     std::vector<Variable> liveIn() override;
     std::vector<Variable> liveOut() override;
+    std::vector<std::string> uses() const override;
+    std::vector<std::string> defs() const override;
 
    private:
 };
 
 class Return : public Instruction {
    public:
+    std::optional<std::string> val;
+
     Return(std::optional<std::string> val) : val(val) {}
     Return(std::string val) : val(std::move(val)) {}
     ~Return() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     bool isTerminator() const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<std::string> uses() const override;
 
    private:
-    std::optional<std::string> val;
 };
 
 class Print : public Instruction {
    public:
+    std::vector<std::string> args;
+
     Print(std::vector<std::string> args) : args(std::move(args)) {}
     ~Print() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<std::string> uses() const override;
 
    private:
-    std::vector<std::string> args;
 };
 
 class Id : public CoreComputeInst {
    public:
+    VarPtr dest;
+    std::string src;
+
     Id(VarPtr dest, std::string src) : dest(dest), src(src) {}
     ~Id() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
+    bool isPure() const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<Variable> liveOut() override;
+    std::vector<std::string> uses() const override;
+    std::vector<std::string> defs() const override;
 
    private:
-    VarPtr dest;
-    std::string src;
 };
 
 class Nop : public Instruction {
@@ -233,70 +300,168 @@ class Nop : public Instruction {
     Nop() = default;
     ~Nop() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
+    bool isPure() const override;
 };
 
 class Alloc : public Instruction {
    public:
+    VarPtr dest;
+    std::string size;
+
     Alloc(VarPtr dest, std::string size) : dest(dest), size(size) {}
     ~Alloc() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<Variable> liveOut() override;
+    std::vector<std::string> uses() const override;
+    std::vector<std::string> defs() const override;
 
    private:
-    VarPtr dest;
-    std::string size;
 };
 
 class Free : public Instruction {
    public:
+    std::string site;
+
     Free(std::string site) : site(site) {}
     ~Free() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<std::string> uses() const override;
 
    private:
-    std::string site;
 };
 
 class Load : public Instruction {
    public:
+    VarPtr dest;
+    std::string ptr;
+    bool checked = true;  // cleared when proven in bounds, see opt::ElideBoundsChecks
+
     Load(VarPtr dest, std::string ptr) : dest(dest), ptr(ptr) {}
     ~Load() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<Variable> liveOut() override;
+    std::vector<std::string> uses() const override;
+    std::vector<std::string> defs() const override;
 
    private:
-    VarPtr dest;
-    std::string ptr;
 };
 
 class Store : public Instruction {
    public:
+    std::string ptr, val;
+    bool checked = true;  // cleared when proven in bounds, see opt::ElideBoundsChecks
+
     Store(std::string ptr, std::string val) : ptr(ptr), val(val) {}
     ~Store() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<std::string> uses() const override;
 
    private:
-    std::string ptr, val;
 };
 
 class PtrAdd : public Instruction {
    public:
+    VarPtr dest;
+    std::string ptr, offset;
+
     PtrAdd(VarPtr dest, std::string ptr, std::string offset) : dest(dest), ptr(ptr), offset(offset) {}
     ~PtrAdd() = default;
     std::ostream& print(std::ostream& os) const override;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
+    bool isPure() const override;
+    ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+    std::vector<Variable> liveOut() override;
+    std::vector<std::string> uses() const override;
+    std::vector<std::string> defs() const override;
+
+   private:
+};
+
+// A superinstruction: two adjacent instructions run in one dispatch, built by
+// opt::FuseInstructions. It prints and analyses as the original pair. 'keep'
+// is false when the first result is dead after the pair and is not written.
+class Fused : public Instruction {
+   public:
+    InstPtr first, second;
+    bool keep;
+
+    Fused(InstPtr first, InstPtr second, bool keep) : first(std::move(first)), second(std::move(second)), keep(keep) {}
+    ~Fused() = default;
+    std::ostream& print(std::ostream& os) const override;
+    bool isTerminator() const override;
+    std::vector<Variable> liveIn() override;
+    std::vector<Variable> liveOut() override;
+    std::vector<std::string> uses() const override;
+    std::vector<std::string> defs() const override;
+
+   private:
+};
+
+// compare, then branch on its result
+class CompareBranch : public Fused {
+   public:
+    std::shared_ptr<BinaryOp> cmp;
+    std::shared_ptr<Branch> branch;
+
+    CompareBranch(std::shared_ptr<BinaryOp> cmp, std::shared_ptr<Branch> branch, bool keep) : Fused(cmp, branch, keep), cmp(cmp), branch(branch) {}
+    ~CompareBranch() = default;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
+    ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+
+   private:
+};
+
+// a constant used right away as an operand of a binary operation
+class ConstBinaryOp : public Fused {
+   public:
+    std::shared_ptr<Constant> c;
+    std::shared_ptr<BinaryOp> op;
+
+    ConstBinaryOp(std::shared_ptr<Constant> c, std::shared_ptr<BinaryOp> op, bool keep) : Fused(c, op, keep), c(c), op(op) {}
+    ~ConstBinaryOp() = default;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
+    ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
+
+   private:
+};
+
+// pointer arithmetic, then a load through the result
+class PtrAddLoad : public Fused {
+   public:
+    std::shared_ptr<PtrAdd> ptrAdd;
+    std::shared_ptr<Load> load;
+
+    PtrAddLoad(std::shared_ptr<PtrAdd> ptrAdd, std::shared_ptr<Load> load, bool keep) : Fused(ptrAdd, load, keep), ptrAdd(ptrAdd), load(load) {}
+    ~PtrAddLoad() = default;
+    InstPtr clone(const Renamer& var, const Renamer& label) const override;
     ctrlStatus execute(varContext& vars, [[maybe_unused]] HeapManager& heap) override;
 
    private:
-    VarPtr dest;
-    std::string ptr, offset;
 };
 
 std::pair<BinaryOpType, TypePtr> StrToBinOp(const std::string& op);
 
+std::string BinOpToStr(BinaryOpType op);
+
 std::pair<UnaryOpType, TypePtr> StrToUnOp(const std::string& op);
 
+// shared by the interpreter and constant folding; arithmetic wraps around
+int64_t EvalBinOp(BinaryOpType op, int64_t lhs, int64_t rhs);
+
+int64_t EvalUnOp(UnaryOpType op, int64_t src);
+
+// the Bril opcode, e.g. "add" or "br"; a fused pair is "lt+br"
+std::string OpcodeName(const Instruction& instr);
+
 InstPtr ParseInstr(const json& instJson);
 
 }  // namespace ir
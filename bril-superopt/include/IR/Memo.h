@@ -0,0 +1,51 @@
+#ifndef IR_MEMO_H
+#define IR_MEMO_H
+
+#include <IR/Type.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace ir {
+
+class Function;
+
+// Direct-mapped cache of call results of pure functions, keyed by the callee
+// and its argument values. A colliding insert replaces the older entry, so
+// memory stays bounded by the slot count.
+class MemoTable {
+   public:
+    using Key = std::vector<int64_t>;
+
+    MemoTable(size_t slots = 1 << 16);
+    ~MemoTable() = default;
+    // the argument values of 'func' bound in its frame 'vars'
+    static Key makeKey(const Function& func, const varContext& vars);
+    // the cached result, nullptr on a miss
+    const std::optional<int64_t>* lookup(const Function& func, const Key& key);
+    void insert(const Function& func, Key key, std::optional<int64_t> ret);
+    // hit/miss counts per function
+    void report(std::ostream& os) const;
+
+   private:
+    struct Slot {
+        const Function* func = nullptr;
+        Key key;
+        std::optional<int64_t> ret;
+    };
+    struct Stats {
+        uint64_t hits = 0, misses = 0;
+    };
+    std::vector<Slot> slots;
+    std::unordered_map<const Function*, Stats> stats;
+
+    Slot& slotFor(const Function& func, const Key& key);
+};
+
+}  // namespace ir
+
+#endif  // IR_MEMO_H
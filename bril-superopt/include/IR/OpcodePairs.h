@@ -0,0 +1,31 @@
+#ifndef IR_OPCODEPAIRS_H
+#define IR_OPCODEPAIRS_H
+
+#include <IR/BasicBlock.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+
+namespace ir {
+
+// Profile of which opcode directly follows which while the interpreter runs,
+// to pick the pairs worth fusing (see opt::FuseInstructions). Only block
+// entries are counted; the pairs are recovered from the block contents.
+class OpcodePairs {
+   public:
+    OpcodePairs() = default;
+    ~OpcodePairs() = default;
+    // 'bb' starts running right after 'prev', nullptr on entry to a function
+    void enter(const BasicBlock* prev, const BasicBlock* bb) { entries[bb][prev]++; }
+    // the 'top' most frequent pairs, most frequent first
+    void report(std::ostream& os, size_t top = 20) const;
+
+   private:
+    std::unordered_map<const BasicBlock*, std::unordered_map<const BasicBlock*, uint64_t>> entries;
+};
+
+}  // namespace ir
+
+#endif  // IR_OPCODEPAIRS_H
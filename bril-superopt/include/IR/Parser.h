@@ -2,12 +2,14 @@
 #define IR_PARSER_H
 
 #include <IR/Program.h>
+#include <IR/Stats.h>
 
 #include <istream>
 
 namespace ir {
 
-ProgramPtr parse(std::istream& input);
+// 'stats' times JSON parsing and IR construction as separate phases
+ProgramPtr parse(std::istream& input, Stats* stats = nullptr);
 
 }  // namespace ir
 
@@ -0,0 +1,44 @@
+#ifndef IR_PERFCOUNTERS_H
+#define IR_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ir {
+
+// Hardware counters of this thread read with perf_event_open(2) between
+// start() and stop(), user space only: cycles, instructions, branch-misses
+// and LLC-load-misses, plus the task-clock in ns. They form one group, so
+// they are scheduled together, and counts are scaled by the share of the
+// time the group ran when the kernel multiplexes it. A counter the machine
+// or kernel does not offer (as in most VMs) reads as nullopt.
+class PerfCounters {
+   public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void start();
+    void stop();
+    // the counts between the last start() and stop(), by perf's event names
+    std::vector<std::pair<std::string, std::optional<uint64_t>>> read() const;
+    // one "<event>: N" line per counter, as total_dyn_inst is reported
+    void report(std::ostream& os) const;
+
+   private:
+    struct Counter {
+        std::string name;
+        int fd;  // -1 if unsupported
+    };
+    std::vector<Counter> counters;
+    int leader = -1;  // the first counter opened
+};
+
+}  // namespace ir
+
+#endif  // IR_PERFCOUNTERS_H
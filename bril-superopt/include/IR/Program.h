@@ -6,6 +6,7 @@
 #include <IR/Type.h>
 
 #include <memory>
+#include <optional>
 #include <nlohmann/json_fwd.hpp>
 #include <string>
 #include <unordered_map>
@@ -17,6 +18,7 @@ namespace ir {
 class Program {
    public:
     FuncPtr mainFunc = nullptr;
+    std::vector<FuncPtr> functions;
 
     Program(const json& progJson);
     ~Program() = default;
@@ -24,10 +26,10 @@ class Program {
     void SetupMainFunc(const std::unordered_map<std::string, FuncWPtr>& name2func);
     varContext SetupVarContext(int argc, char** argv);
     friend std::ostream& operator<<(std::ostream& os, const Program& prog);
-    void execute(varContext& vars, HeapManager& heap);
+    // runs @main; its return value, if any
+    std::optional<int64_t> execute(varContext& vars, HeapManager& heap);
 
    private:
-    std::vector<FuncPtr> functions;
 };
 
 using ProgramPtr = std::shared_ptr<Program>;
@@ -0,0 +1,66 @@
+#ifndef IR_SAMPLER_H
+#define IR_SAMPLER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+
+namespace ir {
+
+class Instruction;
+class Program;
+
+// Statistical profile of the interpreter. A SIGPROF timer fires every 1/hz
+// seconds of process CPU time, or at the kernel's tick rate if that is
+// lower; its handler reads the instruction the interpreter publishes in
+// 'current' (see Function::sampler) and pushes it into a lock-free ring,
+// which the interpreter drains into per-instruction counts between blocks
+// (see poll()). It pays a store per instruction and a check per block, so
+// timings stay close to the unprofiled ones, and it can count exactly (see
+// Function::counting) at the same time. There is no drain thread on
+// purpose: a second thread would make every shared_ptr copy in the process
+// atomic. Only one sampler runs at a time.
+class Sampler {
+   public:
+    // the instruction being executed, null outside the interpreter
+    std::atomic<const Instruction*> current = nullptr;
+
+    // throws if the rate is out of range or the timer cannot be set up
+    Sampler(unsigned hz = 1000);
+    ~Sampler();
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    // collects the samples once the ring is half full
+    void poll() {
+        if (ring.head.load(std::memory_order_relaxed) - ring.tail.load(std::memory_order_relaxed) >= RingSize / 2) drain();
+    }
+    // stops the timer and collects the samples still in the ring
+    void stop();
+    // the sampled instructions of 'prog' as "@func.block[index]", most frequent
+    // first; with the block counts of the counting interpreter when available
+    void report(const Program& prog, std::ostream& os) const;
+
+   private:
+    static constexpr size_t RingSize = 1 << 12;
+    // single producer (the signal handler), single consumer (poll() and stop())
+    struct Ring {
+        const Instruction* slots[RingSize];
+        std::atomic<uint64_t> head = 0, tail = 0;
+        std::atomic<uint64_t> dropped = 0;  // samples lost to a full ring
+    };
+
+    static void handler(int);
+    void drain();
+
+    static inline std::atomic<Sampler*> active = nullptr;
+    Ring ring;
+    std::unordered_map<const Instruction*, uint64_t> counts;  // null: outside the interpreter
+    bool stopped = false;
+};
+
+}  // namespace ir
+
+#endif  // IR_SAMPLER_H
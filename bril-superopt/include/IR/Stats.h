@@ -0,0 +1,61 @@
+#ifndef IR_STATS_H
+#define IR_STATS_H
+
+#include <IR/Heap.h>
+#include <IR/Program.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ir {
+
+// Bytes and blocks handed out by operator new while 'counting'. Only
+// executables replacing it count them (brili does for --stats, being
+// single-threaded); elsewhere both stay 0.
+struct Allocations {
+    bool counting = false;
+    uint64_t bytes = 0, count = 0;
+};
+extern Allocations allocations;
+
+// Wall and CPU time and allocations of the consecutive phases of a run
+// (brili --stats), plus the size of the IR and the peak heap usage.
+class Stats {
+   public:
+    Stats() = default;
+    ~Stats() = default;
+    // ends the running phase, if any, and starts 'name'
+    void phase(std::string name);
+    void end();
+    // records the size of 'prog' as loaded: its functions, blocks and
+    // instructions, its variables (distinct names, summed over functions)
+    // and the Type objects its variables, arguments and returns hold
+    void count(const Program& prog);
+    // one line per phase, then the IR and heap figures
+    void report(std::ostream& os, const HeapManager& heap) const;
+
+   private:
+    struct Phase {
+        std::string name;
+        double wallMs, cpuMs;
+        uint64_t bytes, allocations;
+    };
+    struct Start {
+        std::string name;
+        std::chrono::steady_clock::time_point wall;
+        std::clock_t cpu;
+        Allocations allocated;
+    };
+    std::vector<Phase> phases;
+    std::optional<Start> running;
+    uint64_t functions = 0, blocks = 0, instructions = 0, variables = 0, types = 0;
+};
+
+}  // namespace ir
+
+#endif  // IR_STATS_H
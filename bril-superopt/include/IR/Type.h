@@ -72,6 +72,7 @@ class PointerType : public Type {
     PointerType(TypePtr pointee) : pointee(pointee) {}
     ~PointerType() = default;
     std::ostream& print(std::ostream& os) const override;
+    TypePtr getPointee() const { return pointee; }
 
     bool operator==(const Type& other) const override {
         if (auto otherPtr = dynamic_cast<const PointerType*>(&other)) {
@@ -0,0 +1,109 @@
+#ifndef JIT_ASSEMBLER_H
+#define JIT_ASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jit {
+
+enum Reg : uint8_t {
+    RAX,
+    RCX,
+    RDX,
+    RBX,
+    RSP,
+    RBP,
+    RSI,
+    RDI,
+    R8,
+    R9,
+    R10,
+    R11,
+    R12,
+    R13,
+    R14,
+    R15,
+};
+
+// condition codes, the low nibble of Jcc/SETcc
+enum Cond : uint8_t {
+    CondE = 0x4,
+    CondNE = 0x5,
+    CondL = 0xC,
+    CondGE = 0xD,
+    CondLE = 0xE,
+    CondG = 0xF,
+};
+
+// two-operand ALU ops taking 'reg, r/m64', by their opcode byte
+enum AluOp : uint8_t {
+    AluAdd = 0x03,
+    AluOr = 0x0B,
+    AluAnd = 0x23,
+    AluSub = 0x2B,
+    AluCmp = 0x3B,
+};
+
+// Minimal x86-64 encoder for the baseline JIT: 64-bit moves and ALU ops
+// between registers and [base + disp32] memory, direct/indirect control flow
+// and forward/backward label fixups.
+class Assembler {
+   public:
+    using Label = size_t;
+
+    std::vector<uint8_t> code;
+
+    Assembler() = default;
+    ~Assembler() = default;
+
+    Label newLabel();
+    void bind(Label label);
+    size_t offset(Label label) const { return labels[label].pos; }
+    // patch all jumps to their labels, every label used must be bound
+    void finalize();
+
+    void movImm(Reg dst, int64_t imm);
+    void mov(Reg dst, Reg src);
+    void load(Reg dst, Reg base, int32_t disp);
+    void store(Reg base, int32_t disp, Reg src);
+    void lea(Reg dst, Reg base, int32_t disp);
+    // dst = base + index * 8
+    void leaScaled(Reg dst, Reg base, Reg index);
+    void alu(AluOp op, Reg dst, Reg base, int32_t disp);
+    void imul(Reg dst, Reg base, int32_t disp);
+    void test(Reg lhs, Reg rhs);
+    void cmpImm(Reg lhs, int32_t imm);
+    void subImm(Reg dst, int32_t imm);
+    void xor32(Reg dst, Reg src);
+    // dst = (flags satisfy cond) as 0/1
+    void setcc(Cond cond, Reg dst);
+    void push(Reg reg);
+    void pop(Reg reg);
+    void call(Reg target);
+    void callMem(Reg base, int32_t disp);
+    void jmp(Label label);
+    void jmpReg(Reg target);
+    void jmpMem(Reg base, int32_t disp);
+    void jcc(Cond cond, Label label);
+    void repStosq();
+    void ret();
+
+   private:
+    struct LabelInfo {
+        size_t pos = SIZE_MAX;
+        std::vector<size_t> fixups;  // rel32 fields to patch
+    };
+    std::vector<LabelInfo> labels;
+
+    void byte(uint8_t b) { code.push_back(b); }
+    void imm32(int32_t imm);
+    void rex(bool w, uint8_t reg, uint8_t index, uint8_t base);
+    void modrmReg(uint8_t reg, uint8_t rm);
+    void modrmMem(uint8_t reg, Reg base, int32_t disp);
+    void rel32(Label label);
+};
+
+}  // namespace jit
+
+#endif  // JIT_ASSEMBLER_H
@@ -0,0 +1,32 @@
+#ifndef JIT_CODEMEMORY_H
+#define JIT_CODEMEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jit {
+
+// Machine code copied into its own mmap'd pages and flipped to read+execute.
+// 'cfi' holds the DWARF call frame instructions of the code's prologue; they
+// are wrapped into an .eh_frame CIE/FDE pair and registered with the unwinder
+// so that exceptions thrown by runtime helpers unwind through JIT frames.
+class ExecutableCode {
+   public:
+    ExecutableCode(const std::vector<uint8_t>& code, const std::vector<uint8_t>& cfi);
+    ~ExecutableCode();
+    ExecutableCode(const ExecutableCode&) = delete;
+    ExecutableCode& operator=(const ExecutableCode&) = delete;
+
+    const uint8_t* start() const { return mem; }
+    size_t size() const { return codeSize; }
+
+   private:
+    uint8_t* mem = nullptr;
+    size_t mapSize = 0, codeSize = 0;
+    std::vector<uint8_t> ehFrame;
+};
+
+}  // namespace jit
+
+#endif  // JIT_CODEMEMORY_H
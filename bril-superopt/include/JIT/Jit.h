@@ -0,0 +1,94 @@
+#ifndef JIT_JIT_H
+#define JIT_JIT_H
+
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Heap.h>
+#include <IR/Program.h>
+#include <IR/Type.h>
+#include <JIT/CodeMemory.h>
+#include <JIT/PerfMap.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace jit {
+
+// state shared by every frame of one run, kept in rbx by compiled code
+struct JitContext {
+    ir::HeapManager* heap;
+    int64_t* tailArgs;  // outgoing arguments of a tail call, read by the callee prologue
+};
+
+struct JitFunction;
+// all values are passed as raw 64-bit words; void functions return 0
+using EntryFn = int64_t (*)(const int64_t* args, JitContext* ctx, JitFunction* self);
+
+// One per ir::Function. Compiled calls jump through 'entry', which starts as
+// the interpreter trampoline and is swapped for native code once compiled.
+struct JitFunction {
+    EntryFn entry;
+    ir::Function* func;
+    const uint8_t* code = nullptr;  // native entry, if compiled
+};
+
+// enters compiled code mid-function, see JitEngine::enterAt
+using OsrFn = int64_t (*)(const int64_t* frame, JitContext* ctx, JitFunction* self, int64_t header);
+
+// the OSR entry of a compiled function and the frame layout it expects
+struct OsrInfo {
+    OsrFn entry = nullptr;
+    size_t numSlots = 0;
+    std::unordered_map<std::string, size_t> slotIndex;
+    std::unordered_map<const ir::BasicBlock*, int64_t> headers;  // blocks marked loopHeader
+};
+
+// the typed frame slots printed by one print instruction
+struct PrintSite {
+    std::vector<std::pair<int32_t, ir::TypePtr>> args;  // rbp-relative offset, type
+};
+
+// Baseline template JIT for x86-64: every instruction becomes a fixed
+// sequence over stack slots, one slot per variable. Side effects and
+// anything that can fail (div, alloc, free, load, store, print) call into
+// runtime helpers that share the interpreter's semantics and error messages.
+// Functions using instructions the JIT does not know stay interpreted.
+class JitEngine {
+   public:
+    // compiled code is reported to 'perf', if given
+    JitEngine(ir::Program& prog, PerfMap* perf = nullptr);
+    ~JitEngine() = default;
+    // false if 'func' keeps running in the interpreter
+    bool compile(ir::Function& func);
+    void compileAll();
+    // run @main with the arguments in 'vars'
+    std::optional<int64_t> run(ir::varContext& vars, ir::HeapManager& heap);
+    // call 'func' through its current entry with the arguments bound in 'vars'
+    std::optional<int64_t> invoke(ir::Function& func, const ir::varContext& vars, ir::HeapManager& heap);
+    JitFunction& record(const ir::Function& func) { return *records.at(&func); }
+    // on-stack replacement: whether compiled 'func' can be entered at 'header'
+    bool hasOsrEntry(const ir::Function& func, const ir::BasicBlock& header) const;
+    // resume at 'header' in compiled code with the variables in 'live' taken
+    // from the interpreter frame 'vars'; returns what the function returns
+    std::optional<int64_t> enterAt(ir::Function& func, const ir::BasicBlock& header, const ir::varContext& vars, const std::unordered_set<std::string>& live, ir::HeapManager& heap);
+
+   private:
+    ir::Program& prog;
+    PerfMap* perf;
+    std::unordered_map<const ir::Function*, std::unique_ptr<JitFunction>> records;
+    std::unordered_map<const ir::Function*, OsrInfo> osrInfo;
+    std::vector<std::unique_ptr<ExecutableCode>> code;
+    std::vector<std::unique_ptr<PrintSite>> printSites;
+    std::vector<int64_t> tailArgs;
+};
+
+}  // namespace jit
+
+#endif  // JIT_JIT_H
@@ -0,0 +1,41 @@
+#ifndef JIT_PERFMAP_H
+#define JIT_PERFMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace jit {
+
+// Names generated code for Linux perf. Every region is appended to
+// /tmp/perf-<pid>.map, which 'perf report' reads for anonymous executable
+// memory. With 'jitdump' the regions and their bytes also go to
+// /tmp/jit-<pid>.dump, which 'perf inject --jit' merges into a recording made
+// with 'perf record -k mono' so that the generated code can be annotated.
+class PerfMap {
+   public:
+    PerfMap(bool jitdump = false);
+    ~PerfMap();
+    PerfMap(const PerfMap&) = delete;
+    PerfMap& operator=(const PerfMap&) = delete;
+
+    // 'size' bytes of code at 'code', split into named regions that start at
+    // the given offsets, in increasing order; the last one runs to the end
+    void add(const uint8_t* code, size_t size, const std::vector<std::pair<size_t, std::string>>& regions);
+
+   private:
+    std::ofstream map;
+    int dumpFd = -1;
+    void* marker = nullptr;  // the mapping that announces the dump file to perf
+    size_t markerSize = 0;
+    uint64_t codeIndex = 0;
+
+    void dump(const uint8_t* code, size_t size, const std::string& name);
+};
+
+}  // namespace jit
+
+#endif  // JIT_PERFMAP_H
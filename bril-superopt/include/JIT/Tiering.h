@@ -0,0 +1,52 @@
+#ifndef JIT_TIERING_H
+#define JIT_TIERING_H
+
+#include <Analysis/Liveness.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Heap.h>
+#include <IR/Program.h>
+#include <IR/Type.h>
+#include <JIT/Jit.h>
+#include <JIT/PerfMap.h>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace jit {
+
+struct TierParams {
+    uint64_t callThreshold = 100;       // invocations before a function is compiled
+    uint64_t backEdgeThreshold = 1000;  // loop back edges before a function is compiled
+    bool log = false;                   // report tier-up events on stderr
+    PerfMap* perfMap = nullptr;         // names compiled code for Linux perf
+};
+
+// Mixed-mode execution: everything starts in the interpreter, which counts
+// invocations and back edges per function (see ir::TierHook). A function
+// crossing a threshold is compiled and its entry swapped, so interpreted and
+// compiled callers alike reach the native code from the next call on. An
+// activation still interpreting a loop of a compiled function moves into the
+// native code at the loop header (OSR), carrying the variables live there.
+class TieredEngine : public ir::TierHook {
+   public:
+    TieredEngine(ir::Program& prog, const TierParams& params = {});
+    ~TieredEngine();
+    bool promote(ir::Function& func) override;
+    bool enterLoop(ir::Function& func, ir::BasicBlock& header, ir::varContext& vars, ir::HeapManager& heap, std::optional<int64_t>& ret) override;
+    std::optional<int64_t> run(ir::varContext& vars, ir::HeapManager& heap);
+
+   private:
+    ir::Program& prog;
+    JitEngine engine;
+    bool log;
+    std::unordered_set<const ir::Function*> rejected;  // not compilable, stays interpreted
+    std::unordered_map<const ir::Function*, opt::Liveness> liveness;  // for OSR, computed on demand
+    std::unordered_set<const ir::Function*> osrLogged;
+};
+
+}  // namespace jit
+
+#endif  // JIT_TIERING_H
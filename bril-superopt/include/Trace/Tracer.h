@@ -0,0 +1,94 @@
+#ifndef TRACE_TRACER_H
+#define TRACE_TRACER_H
+
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Heap.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+#include <IR/Type.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace trace {
+
+struct TraceParams {
+    uint64_t loopThreshold = 50;  // back edges into a loop header before its path is recorded
+    uint64_t exitThreshold = 50;  // failures of a guard before its side exit is recorded
+    size_t maxBlocks = 64;        // longest path recorded
+    bool log = false;             // report recorded traces on stderr
+};
+
+// Trace-based execution of hot loops in the interpreter. Function::execute
+// reports every block transition (see ir::TraceHook); once a loop header is
+// hot, the blocks taken from it until it comes around again are recorded and
+// lowered into one straight-line trace: labels and jumps disappear, adjacent
+// instructions are fused across block boundaries and each branch becomes a
+// guard on the recorded direction. A failing guard leaves the trace for the
+// interpreter at the other successor; a guard that keeps failing gets a side
+// trace recorded from its exit, which then runs in place of the exit.
+// Traces are not compiled: their steps still run through the interpreter's
+// Instruction::execute, which saves only the block dispatch (0-15% over
+// plain interpretation). Lowering them through jit::Assembler, with guards as
+// conditional jumps to side exits, is left for later.
+class TraceEngine : public ir::TraceHook {
+   public:
+    TraceEngine(ir::Program& prog, const TraceParams& params = {});
+    ~TraceEngine();
+    ir::BBPtr transition(ir::Function& func, ir::BasicBlock& from, ir::BBPtr to, ir::varContext& vars, ir::HeapManager& heap) override;
+    std::optional<int64_t> run(ir::varContext& vars, ir::HeapManager& heap);
+
+   private:
+    struct Trace;
+    struct Guard {
+        bool expected;  // the recorded direction
+        ir::BBPtr exit;  // where the interpreter resumes when the guard fails
+        uint64_t failures = 0;
+        Trace* side = nullptr;  // runs instead of the exit once recorded
+    };
+    struct Step {
+        ir::Instruction* instr;
+        int guard = -1;  // index into Trace::guards for a branch
+    };
+    struct Trace {
+        ir::Function* func;
+        ir::BBPtr anchor;  // first block: a loop header or a side exit
+        std::vector<Step> steps;
+        std::vector<Guard> guards;
+        std::vector<ir::InstPtr> fused;  // superinstructions owned by the trace
+        ir::BBPtr next;  // block after the last one
+        Trace* link = nullptr;  // trace anchored at 'next', itself for a loop
+    };
+    struct Recording {
+        ir::Function* func;
+        ir::BBPtr anchor;
+        Guard* sideOf;  // the guard whose exit is recorded, nullptr for a loop
+        std::vector<std::pair<ir::BasicBlock*, ir::BBPtr>> path;  // each block and the successor taken
+        const ir::BasicBlock* expected;  // the block the next transition must leave
+        uint64_t foreign = 0;  // transitions of other activations since the last step
+    };
+
+    ir::Program& prog;
+    TraceParams params;
+    std::vector<std::unique_ptr<Trace>> traces;
+    std::unordered_map<const ir::BasicBlock*, Trace*> byAnchor;
+    std::unordered_map<const ir::BasicBlock*, uint64_t> backEdges;
+    std::unordered_map<const ir::BasicBlock*, int> aborts;  // anchors given up on after a few
+    std::optional<Recording> recording;
+
+    ir::BBPtr execute(Trace* trace, ir::varContext& vars, ir::HeapManager& heap);
+    void startRecording(ir::Function& func, ir::BBPtr anchor, Guard* sideOf);
+    void record(ir::Function& func, ir::BasicBlock& from, const ir::BBPtr& to);
+    void abortRecording();
+    Trace* lower(const Recording& rec);
+};
+
+}  // namespace trace
+
+#endif  // TRACE_TRACER_H
@@ -0,0 +1,18 @@
+#ifndef TRANSFORM_BOUNDSCHECK_H
+#define TRANSFORM_BOUNDSCHECK_H
+
+#include <IR/Function.h>
+
+namespace opt {
+
+// Clears 'checked' on the loads and stores that opt::SafeAccesses proves in
+// bounds, so no engine calls HeapManager::boundCheck for them. Run it last:
+// later transforms may invalidate the proof. Returns true if any was cleared.
+bool ElideBoundsChecks(ir::Function& func);
+
+// sets 'checked' on every load and store again
+void RestoreBoundsChecks(ir::Function& func);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_BOUNDSCHECK_H
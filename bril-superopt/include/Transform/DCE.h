@@ -0,0 +1,15 @@
+#ifndef TRANSFORM_DCE_H
+#define TRANSFORM_DCE_H
+
+#include <IR/Function.h>
+
+namespace opt {
+
+// Dead code elimination driven by global liveness: removes pure instructions
+// whose results are never read, iterating until no more die. Returns true if
+// the function changed.
+bool DCE(ir::Function& func);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_DCE_H
@@ -0,0 +1,17 @@
+#ifndef TRANSFORM_DSE_H
+#define TRANSFORM_DSE_H
+
+#include <IR/Function.h>
+
+namespace opt {
+
+// Dead store elimination. Drops stores into allocations that are never loaded
+// from and do not escape the function, and stores followed in the same block by
+// a 'free' of the same allocation with no possible read in between. Only
+// stores opt::SafeAccesses proves in bounds go: the others may fail. Returns
+// true if the function changed.
+bool DSE(ir::Function& func);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_DSE_H
@@ -0,0 +1,23 @@
+#ifndef TRANSFORM_FUSE_H
+#define TRANSFORM_FUSE_H
+
+#include <Analysis/Liveness.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+
+namespace opt {
+
+// Lowering for the interpreter: replaces the most frequent adjacent pairs
+// (as reported by --pair-profile) with superinstructions, a compare feeding
+// a branch, a constant feeding a binary operation and a ptradd feeding a
+// load, so each pair costs one dispatch. Run it after all other passes.
+// Returns true if the function changed.
+bool FuseInstructions(ir::Function& func);
+
+// the superinstruction for 'first; second', nullptr if they do not form one;
+// 'live' holds the variables live after the pair, nullptr keeps every result
+ir::InstPtr FusePair(const ir::InstPtr& first, const ir::InstPtr& second, const VarSet* live = nullptr);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_FUSE_H
@@ -0,0 +1,39 @@
+#ifndef TRANSFORM_INLINE_H
+#define TRANSFORM_INLINE_H
+
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace opt {
+
+struct InlineParams {
+    size_t sizeThreshold = 24;      // callee instructions worth inlining anywhere
+    size_t hotSizeThreshold = 128;  // limit for call sites with at least 'hotCount' hits
+    uint64_t hotCount = 100;
+    size_t maxFunctionSize = 4096;  // callers do not grow past this
+    bool useProfile = false;        // Call::hits come from a profile, unexecuted sites stay calls
+};
+
+// Inline calls bottom-up over the call graph. The callee CFG is cloned with
+// its variables and labels prefixed, arguments become 'id' copies (unless the
+// callee never assigns the parameter, which then reads the argument) and every
+// 'ret' a jump to a continuation block split off after the call, unless the
+// call is in tail position and its returns can stay. Direct self-recursion is
+// left alone. Returns true if the program changed.
+bool Inline(ir::Program& prog, const InlineParams& params = {});
+
+using CallSelector = std::function<bool(const ir::Call& call, const ir::Function& callee)>;
+
+// Inline the calls of 'caller' that 'select' accepts, in layout order. Calls
+// cloned in from a callee are not visited again, nor is direct recursion.
+// Returns true if 'caller' changed.
+bool InlineCalls(ir::Function& caller, const CallSelector& select);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_INLINE_H
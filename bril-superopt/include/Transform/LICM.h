@@ -0,0 +1,16 @@
+#ifndef TRANSFORM_LICM_H
+#define TRANSFORM_LICM_H
+
+#include <IR/Function.h>
+
+namespace opt {
+
+// Loop-invariant code motion. Hoists pure computations whose operands are
+// defined outside the loop into the loop preheader, inner loops first. 'div'
+// only moves when its divisor is a known non-zero constant; loads, stores and
+// calls never move. Returns true if the function changed.
+bool LICM(ir::Function& func);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_LICM_H
@@ -0,0 +1,32 @@
+#ifndef TRANSFORM_LOOPUTILS_H
+#define TRANSFORM_LOOPUTILS_H
+
+#include <Analysis/Loops.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+
+#include <string>
+
+namespace opt {
+
+// a label name based on 'hint' that is not used in 'func' yet
+std::string FreshLabel(const ir::Function& func, const std::string& hint);
+
+// the label 'bb' starts with, inserting a fresh one based on 'hint' if it has none
+std::string EnsureLabel(const ir::Function& func, ir::BasicBlock& bb, const std::string& hint = "bb");
+
+// retarget the edges 'from' -> 'oldSucc' to 'newSucc', patching the terminator
+void RedirectEdge(ir::BasicBlock& from, const ir::BasicBlock* oldSucc, const ir::BBPtr& newSucc, const std::string& newLabel);
+
+// append 'instr' to 'bb', keeping its terminator last
+void InsertBeforeTerminator(ir::BasicBlock& bb, ir::InstPtr instr);
+
+// The single block outside 'loop' that enters it, created when the header
+// has several outside predecessors or its predecessor has other successors.
+// The new block is laid out right before the header and falls through into it.
+ir::BBPtr GetOrInsertPreheader(ir::Function& func, const Loop& loop);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_LOOPUTILS_H
@@ -0,0 +1,23 @@
+#ifndef TRANSFORM_PASSES_H
+#define TRANSFORM_PASSES_H
+
+#include <IR/Program.h>
+
+#include <string>
+#include <vector>
+
+namespace opt {
+
+struct PassOptions {
+    bool callProfile = false;  // Call::hits were loaded from a profile
+};
+
+// run the named passes over 'prog' in order, e.g. {"sccp", "dce"}
+void RunPasses(ir::Program& prog, const std::vector<std::string>& passes, const PassOptions& options = {});
+
+// split a comma-separated pass list
+std::vector<std::string> ParsePassList(const std::string& list);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_PASSES_H
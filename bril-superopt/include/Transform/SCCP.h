@@ -0,0 +1,17 @@
+#ifndef TRANSFORM_SCCP_H
+#define TRANSFORM_SCCP_H
+
+#include <IR/Function.h>
+
+namespace opt {
+
+// Sparse conditional constant propagation. Only blocks reachable through
+// executable edges contribute to the lattice, so constants flow through
+// branches whose condition is itself constant. Folds computations to 'const',
+// turns constant 'br' into 'jmp' and drops the blocks left unreachable.
+// Returns true if the function changed.
+bool SCCP(ir::Function& func);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_SCCP_H
@@ -0,0 +1,22 @@
+#ifndef TRANSFORM_SCALARREPL_H
+#define TRANSFORM_SCALARREPL_H
+
+#include <IR/Function.h>
+
+#include <cstdint>
+
+namespace opt {
+
+// Scalar replacement of allocations. An 'alloc' of a constant size (at most
+// 'maxSize' elements) that does not escape the function, and whose every
+// access goes through a pointer at a constant offset, becomes one variable
+// per element: the 'alloc' sets them to 0 like fresh heap words, loads and
+// stores turn into 'id' copies, and the 'free' and the pointer arithmetic
+// disappear, so the heap never sees it. Accesses after the 'free', and
+// allocations of pointers, stay on the heap. Returns true if the function
+// changed.
+bool ScalarReplace(ir::Function& func, int64_t maxSize = 64);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_SCALARREPL_H
@@ -0,0 +1,30 @@
+#ifndef TRANSFORM_SPECIALIZE_H
+#define TRANSFORM_SPECIALIZE_H
+
+#include <IR/Program.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace opt {
+
+struct SpecializeParams {
+    size_t unrollBudget = 1024;  // instructions @main may grow by through inlining and unrolling
+    bool inlineCalls = true;     // inline into @main first so constants reach callee code
+};
+
+// Partially evaluate 'prog' on known arguments of @main, given by name. They
+// leave the signature and become constants in a new entry block; inlining,
+// SCCP and DCE then propagate them. Besides the small callees Inline takes
+// anywhere, @main inlines every call that passes it a constant, to functions
+// outside call cycles, within the budget. Loops of @main whose exits fold to
+// constants are fully unrolled by peeling one iteration at a time, each
+// peeled copy simplified by SCCP, until the original loop becomes
+// unreachable or the budget runs out.
+void Specialize(ir::Program& prog, const std::unordered_map<std::string, int64_t>& known, const SpecializeParams& params = {});
+
+}  // namespace opt
+
+#endif  // TRANSFORM_SPECIALIZE_H
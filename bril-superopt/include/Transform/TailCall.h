@@ -0,0 +1,15 @@
+#ifndef TRANSFORM_TAILCALL_H
+#define TRANSFORM_TAILCALL_H
+
+#include <IR/Function.h>
+
+namespace opt {
+
+// Tail recursion elimination: 'call @self args; ret result' becomes copies of
+// the arguments into the parameters followed by a jump back to the entry block.
+// Returns true if the function changed.
+bool TailCallElim(ir::Function& func);
+
+}  // namespace opt
+
+#endif  // TRANSFORM_TAILCALL_H
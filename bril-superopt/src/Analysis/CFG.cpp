@@ -0,0 +1,50 @@
+#include <Analysis/CFG.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace opt {
+
+PredMap Predecessors(const ir::Function& func) {
+    PredMap preds;
+    for (const auto& bb : func.basicBlocks) {
+        preds[bb.get()];
+        for (const auto& succ : bb->successors()) preds[succ.get()].push_back(bb.get());
+    }
+    return preds;
+}
+
+std::vector<ir::BasicBlock*> ReversePostOrder(const ir::Function& func) {
+    std::vector<ir::BasicBlock*> order;
+    ir::BBPtr entry = func.getEntry();
+    if (!entry) return order;
+    // iterative DFS, a block is emitted once all its successors are visited
+    std::unordered_set<ir::BasicBlock*> visited{entry.get()};
+    std::vector<std::pair<ir::BasicBlock*, std::vector<ir::BBPtr>>> stack;
+    stack.emplace_back(entry.get(), entry->successors());
+    while (!stack.empty()) {
+        auto& [bb, succs] = stack.back();
+        if (succs.empty()) {
+            order.push_back(bb);
+            stack.pop_back();
+            continue;
+        }
+        ir::BBPtr next = succs.back();
+        succs.pop_back();
+        if (visited.insert(next.get()).second) stack.emplace_back(next.get(), next->successors());
+    }
+    std::ranges::reverse(order);
+    return order;
+}
+
+ir::BBPtr FindBlock(const ir::Function& func, const ir::BasicBlock* bb) {
+    auto it = std::ranges::find_if(func.basicBlocks, [&](const ir::BBPtr& b) { return b.get() == bb; });
+    return it == func.basicBlocks.end() ? nullptr : *it;
+}
+
+}  // namespace opt
@@ -0,0 +1,61 @@
+#include <Analysis/CFG.h>
+#include <Analysis/Dominators.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace opt {
+
+// "A Simple, Fast Dominance Algorithm", Cooper, Harvey and Kennedy
+DominatorTree::DominatorTree(const ir::Function& func) {
+    auto rpo = ReversePostOrder(func);
+    if (rpo.empty()) return;
+    auto preds = Predecessors(func);
+    std::unordered_map<const ir::BasicBlock*, size_t> index;
+    for (size_t i = 0; i < rpo.size(); i++) index[rpo[i]] = i;
+
+    auto intersect = [&](const ir::BasicBlock* a, const ir::BasicBlock* b) {
+        while (a != b) {
+            while (index.at(a) > index.at(b)) a = idoms.at(a);
+            while (index.at(b) > index.at(a)) b = idoms.at(b);
+        }
+        return a;
+    };
+    const ir::BasicBlock* entry = rpo.front();
+    idoms[entry] = entry;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t i = 1; i < rpo.size(); i++) {
+            const ir::BasicBlock* newIdom = nullptr;
+            for (const auto* pred : preds[rpo[i]]) {
+                if (!idoms.contains(pred)) continue;  // unreachable or not processed yet
+                newIdom = newIdom ? intersect(pred, newIdom) : pred;
+            }
+            if (auto it = idoms.find(rpo[i]); it == idoms.end() || it->second != newIdom) {
+                idoms[rpo[i]] = newIdom;
+                changed = true;
+            }
+        }
+    }
+    idoms[entry] = nullptr;
+}
+
+const ir::BasicBlock* DominatorTree::idom(const ir::BasicBlock* bb) const {
+    auto it = idoms.find(bb);
+    return it == idoms.end() ? nullptr : it->second;
+}
+
+bool DominatorTree::dominates(const ir::BasicBlock* a, const ir::BasicBlock* b) const {
+    if (!reachable(b)) return false;
+    for (const ir::BasicBlock* cur = b; cur; cur = idom(cur))
+        if (cur == a) return true;
+    return false;
+}
+
+bool DominatorTree::reachable(const ir::BasicBlock* bb) const {
+    return idoms.contains(bb);
+}
+
+}  // namespace opt
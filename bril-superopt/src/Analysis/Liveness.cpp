@@ -0,0 +1,54 @@
+#include <Analysis/CFG.h>
+#include <Analysis/Liveness.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+
+#include <deque>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+void StepLiveness(const ir::Instruction& instr, VarSet& live) {
+    for (const auto& def : instr.defs()) live.erase(def);
+    for (const auto& use : instr.uses()) live.insert(use);
+}
+
+Liveness::Liveness(const ir::Function& func) {
+    auto preds = Predecessors(func);
+    for (const auto& bb : func.basicBlocks) in[bb.get()], out[bb.get()];
+    // backward may-analysis, seeded in reverse layout order for fast convergence
+    std::deque<const ir::BasicBlock*> worklist;
+    std::unordered_set<const ir::BasicBlock*> queued;
+    for (const auto& bb : func.basicBlocks | std::views::reverse) {
+        worklist.push_back(bb.get());
+        queued.insert(bb.get());
+    }
+    while (!worklist.empty()) {
+        const ir::BasicBlock* bb = worklist.front();
+        worklist.pop_front();
+        queued.erase(bb);
+        VarSet& bbOut = out[bb];
+        for (const auto& succ : bb->successors())
+            bbOut.insert(in[succ.get()].begin(), in[succ.get()].end());
+        VarSet live = bbOut;
+        for (const auto& instr : bb->instrs | std::views::reverse) StepLiveness(*instr, live);
+        if (live == in[bb]) continue;
+        in[bb] = std::move(live);
+        for (const auto* pred : preds[bb])
+            if (queued.insert(pred).second) worklist.push_back(pred);
+    }
+}
+
+const VarSet& Liveness::liveIn(const ir::BasicBlock* bb) const {
+    return in.at(bb);
+}
+
+const VarSet& Liveness::liveOut(const ir::BasicBlock* bb) const {
+    return out.at(bb);
+}
+
+}  // namespace opt
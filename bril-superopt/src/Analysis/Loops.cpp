@@ -0,0 +1,93 @@
+#include <Analysis/CFG.h>
+#include <Analysis/Dominators.h>
+#include <Analysis/Loops.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace opt {
+
+std::vector<ir::BasicBlock*> Loop::exitBlocks() const {
+    std::vector<ir::BasicBlock*> exits;
+    for (const auto* bb : blocks)
+        for (const auto& succ : bb->successors())
+            if (!contains(succ.get()) && std::ranges::find(exits, succ.get()) == exits.end())
+                exits.push_back(succ.get());
+    return exits;
+}
+
+LoopInfo::LoopInfo(const ir::Function& func, const DominatorTree& domTree) {
+    auto preds = Predecessors(func);
+    std::unordered_map<const ir::BasicBlock*, Loop*> byHeader;
+    for (auto* bb : ReversePostOrder(func)) {
+        for (const auto& succ : bb->successors()) {
+            if (!domTree.dominates(succ.get(), bb)) continue;
+            // back edge bb -> succ
+            Loop*& loop = byHeader[succ.get()];
+            if (!loop) {
+                loops.push_back(std::make_unique<Loop>());
+                loop = loops.back().get();
+                loop->header = succ.get();
+                loop->blocks.insert(succ.get());
+            }
+            loop->latches.push_back(bb);
+            // walk predecessors backwards from the latch up to the header
+            std::vector<const ir::BasicBlock*> stack{bb};
+            while (!stack.empty()) {
+                const ir::BasicBlock* cur = stack.back();
+                stack.pop_back();
+                if (!loop->blocks.insert(cur).second) continue;
+                for (const auto* pred : preds[cur])
+                    if (domTree.reachable(pred)) stack.push_back(pred);
+            }
+        }
+    }
+    // nest: the parent of a loop is the smallest other loop containing its header
+    for (const auto& loop : loops) {
+        for (const auto& other : loops) {
+            if (other.get() == loop.get() || !other->contains(loop->header)) continue;
+            if (!loop->parent || loop->parent->blocks.size() > other->blocks.size()) loop->parent = other.get();
+        }
+        if (loop->parent)
+            loop->parent->children.push_back(loop.get());
+        else
+            roots.push_back(loop.get());
+    }
+    for (const auto& loop : loops) {
+        for (const auto* bb : loop->blocks) {
+            Loop*& inner = innermost[bb];
+            if (!inner || inner->blocks.size() > loop->blocks.size()) inner = loop.get();
+        }
+    }
+}
+
+std::vector<Loop*> LoopInfo::postOrder() const {
+    std::vector<Loop*> order;
+    std::function<void(Loop*)> visit = [&](Loop* loop) {
+        for (auto* child : loop->children) visit(child);
+        order.push_back(loop);
+    };
+    for (auto* root : roots) visit(root);
+    return order;
+}
+
+Loop* LoopInfo::loopFor(const ir::BasicBlock* bb) const {
+    auto it = innermost.find(bb);
+    return it == innermost.end() ? nullptr : it->second;
+}
+
+void MarkLoops(ir::Function& func) {
+    DominatorTree domTree(func);
+    LoopInfo loops(func, domTree);
+    for (const auto* loop : loops.postOrder()) {
+        loop->header->loopHeader = true;
+        for (auto* latch : loop->latches) latch->loopLatch = true;
+    }
+}
+
+}  // namespace opt
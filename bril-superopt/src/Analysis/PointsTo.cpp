@@ -0,0 +1,85 @@
+#include <Analysis/PointsTo.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace opt {
+
+PointsTo::PointsTo(const ir::Function& func) {
+    for (const auto& arg : func.args) pts[arg->name].insert(UnknownSite);
+    for (const auto& bb : func.basicBlocks) {
+        for (const auto& instr : bb->instrs) {
+            if (auto alloc = std::dynamic_pointer_cast<ir::Alloc>(instr)) {
+                pts[alloc->dest->name].insert(sites.size());
+                sites.push_back(alloc);
+            } else if (std::dynamic_pointer_cast<ir::Load>(instr) || std::dynamic_pointer_cast<ir::Call>(instr)) {
+                for (const auto& def : instr->defs()) pts[def].insert(UnknownSite);
+            }
+        }
+    }
+    // copies and pointer arithmetic propagate sets until nothing changes
+    for (bool changed = true; changed;) {
+        changed = false;
+        auto flow = [&](const std::string& dest, const std::string& src) {
+            auto it = pts.find(src);
+            if (it == pts.end()) return;
+            auto& destPts = pts[dest];
+            auto before = destPts.size();
+            destPts.insert(it->second.begin(), it->second.end());
+            changed |= destPts.size() != before;
+        };
+        for (const auto& bb : func.basicBlocks) {
+            for (const auto& instr : bb->instrs) {
+                if (auto id = std::dynamic_pointer_cast<ir::Id>(instr))
+                    flow(id->dest->name, id->src);
+                else if (auto ptrAdd = std::dynamic_pointer_cast<ir::PtrAdd>(instr))
+                    flow(ptrAdd->dest->name, ptrAdd->ptr);
+            }
+        }
+    }
+    escaped.assign(sites.size(), false);
+    auto escape = [&](const std::string& var) {
+        for (int site : pointees(var))
+            if (site != UnknownSite) escaped[site] = true;
+    };
+    for (const auto& bb : func.basicBlocks) {
+        for (const auto& instr : bb->instrs) {
+            if (auto call = std::dynamic_pointer_cast<ir::Call>(instr)) {
+                for (const auto& arg : call->args) escape(arg);
+            } else if (auto ret = std::dynamic_pointer_cast<ir::Return>(instr)) {
+                if (ret->val) escape(*ret->val);
+            } else if (auto store = std::dynamic_pointer_cast<ir::Store>(instr)) {
+                escape(store->val);
+            }
+        }
+    }
+}
+
+const std::set<int>& PointsTo::pointees(const std::string& var) const {
+    static const std::set<int> unknown = {UnknownSite};
+    auto it = pts.find(var);
+    return it == pts.end() ? unknown : it->second;
+}
+
+bool PointsTo::escapes(int site) const {
+    return site == UnknownSite || escaped[site];
+}
+
+bool PointsTo::mayAlias(const std::string& lhs, const std::string& rhs) const {
+    const auto &l = pointees(lhs), &r = pointees(rhs);
+    for (int site : l) {
+        if (r.contains(site)) return true;
+        // an unknown pointer may be any escaped allocation
+        if (site == UnknownSite && std::ranges::any_of(r, [&](int s) { return escapes(s); })) return true;
+        if (escapes(site) && r.contains(UnknownSite)) return true;
+    }
+    return false;
+}
+
+}  // namespace opt
@@ -0,0 +1,87 @@
+#include <Analysis/Profile.h>
+#include <IR/BasicBlock.h>
+#include <IR/DynCount.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <vector>
+using json = nlohmann::json;
+
+namespace opt {
+
+static std::vector<std::shared_ptr<ir::Call>> CallSites(const ir::Function& func) {
+    std::vector<std::shared_ptr<ir::Call>> calls;
+    for (const auto& bb : func.basicBlocks)
+        for (const auto& instr : bb->instrs)
+            if (auto call = std::dynamic_pointer_cast<ir::Call>(instr)) calls.push_back(call);
+    return calls;
+}
+
+std::vector<std::shared_ptr<ir::Call>> CallSites(const ir::Program& prog) {
+    std::vector<std::shared_ptr<ir::Call>> calls;
+    for (const auto& func : prog.functions) std::ranges::move(CallSites(*func), std::back_inserter(calls));
+    return calls;
+}
+
+void WriteCallProfile(const ir::Program& prog, std::ostream& os) {
+    json sites = json::object();
+    for (const auto& func : prog.functions) {
+        json counts = json::array();
+        // a call runs once per run of its block
+        for (const auto& bb : func->basicBlocks)
+            for (const auto& instr : bb->instrs)
+                if (dynamic_cast<const ir::Call*>(instr.get())) counts.push_back(bb->runs);
+        sites[func->name] = counts;
+    }
+    os << json{{"call_sites", sites}}.dump(2) << std::endl;
+}
+
+static json Edge(const ir::Function& func, const ir::BBWPtr& succ, uint64_t count) {
+    auto bb = succ.lock();
+    if (!bb) return nullptr;
+    return json{{"to", func.blockName(*bb)}, {"count", count}};
+}
+
+void WriteBlockProfile(const ir::Program& prog, std::ostream& os) {
+    json blocks = json::object();
+    for (const auto& func : prog.functions) {
+        json counts = json::array();
+        for (const auto& bb : func->basicBlocks) {
+            json block = {{"block", func->blockName(*bb)}, {"runs", bb->runs}, {"instrs", ir::InstructionCount(*bb)}};
+            if (auto edge = Edge(*func, bb->taken, bb->takenRuns); !edge.is_null()) block["taken"] = edge;
+            if (auto edge = Edge(*func, bb->notTaken, bb->notTakenRuns); !edge.is_null()) block["not_taken"] = edge;
+            counts.push_back(block);
+        }
+        blocks[func->name] = counts;
+    }
+    os << json{{"blocks", blocks}}.dump(2) << std::endl;
+}
+
+void WriteFoldedProfile(const ir::Program& prog, std::ostream& os) {
+    for (const auto& func : prog.functions)
+        for (const auto& bb : func->basicBlocks)
+            if (uint64_t count = bb->runs * ir::InstructionCount(*bb))
+                os << std::format("@{};{} {}\n", func->name, func->blockName(*bb), count);
+}
+
+void ReadCallProfile(ir::Program& prog, std::istream& is) {
+    json profile = json::parse(is);
+    if (!profile.contains("call_sites")) throw std::runtime_error("profile does not contain 'call_sites'");
+    const json& sites = profile["call_sites"];
+    for (const auto& func : prog.functions) {
+        if (!sites.contains(func->name)) continue;
+        auto calls = CallSites(*func);
+        const json& counts = sites[func->name];
+        if (counts.size() != calls.size()) throw std::runtime_error("profile does not match the calls of @" + func->name);
+        for (size_t i = 0; i < calls.size(); i++) calls[i]->hits = counts[i];
+    }
+}
+
+}  // namespace opt
@@ -0,0 +1,50 @@
+#include <Analysis/Purity.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+using namespace ir;
+
+static bool HasEffect(const InstPtr& instr) {
+    return std::dynamic_pointer_cast<Print>(instr) || std::dynamic_pointer_cast<Alloc>(instr) || std::dynamic_pointer_cast<Free>(instr) ||
+           std::dynamic_pointer_cast<Store>(instr) || std::dynamic_pointer_cast<Load>(instr);
+}
+
+std::unordered_set<const Function*> PureFunctions(const Program& prog) {
+    std::unordered_set<const Function*> pure;
+    std::unordered_map<const Function*, std::vector<const Function*>> callees;
+    for (const auto& func : prog.functions) {
+        bool effect = false;
+        for (const auto& bb : func->basicBlocks) {
+            for (const auto& instr : bb->instrs) {
+                effect |= HasEffect(instr);
+                if (auto call = std::dynamic_pointer_cast<Call>(instr)) callees[func.get()].push_back(call->func.lock().get());
+            }
+        }
+        if (!effect) pure.insert(func.get());
+    }
+    // drop callers of impure functions until nothing changes
+    for (bool changed = true; changed;) {
+        changed = false;
+        std::erase_if(pure, [&](const Function* func) {
+            for (const Function* callee : callees[func]) {
+                if (!pure.contains(callee)) {
+                    changed = true;
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+    return pure;
+}
+
+}  // namespace opt
@@ -0,0 +1,461 @@
+#include <Analysis/CFG.h>
+#include <Analysis/PointsTo.h>
+#include <Analysis/Ranges.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Type.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+constexpr int64_t NoLower = std::numeric_limits<int64_t>::min();
+constexpr int64_t NoUpper = std::numeric_limits<int64_t>::max();
+// visits of a block before its entry state is widened
+constexpr int WidenAfter = 8;
+
+// value <= var + k, or value <= k when 'var' is empty; k == NoUpper is no bound
+struct Bound {
+    std::string var;
+    int64_t k = NoUpper;
+
+    bool bounded() const { return k != NoUpper; }
+    bool operator==(const Bound& other) const = default;
+};
+
+struct Interval {
+    int64_t lo = NoLower;
+    Bound hi;
+
+    bool isConst() const { return hi.var.empty() && hi.k == lo; }
+    bool operator==(const Interval& other) const = default;
+};
+
+// a pointer to element 'offset' of the allocation made by alloc site 'site'
+struct PtrFact {
+    int site;
+    Interval offset;
+
+    bool operator==(const PtrFact& other) const = default;
+};
+
+// the bool variable holds 'lhs op rhs', negated by 'not'
+struct Compare {
+    BinaryOpType op;
+    std::string lhs, rhs;
+    bool negated = false;
+
+    bool operator==(const Compare& other) const = default;
+};
+
+// what holds at one program point; anything absent is unknown
+struct State {
+    std::unordered_map<std::string, Interval> ints;
+    std::unordered_map<std::string, PtrFact> ptrs;
+    std::unordered_map<int, Bound> sizes;  // live allocations, by exact size
+    std::unordered_map<std::string, Compare> conds;
+
+    bool operator==(const State& other) const = default;
+};
+
+std::optional<int64_t> CheckedAdd(int64_t a, int64_t b) {
+    int64_t sum;
+    if (__builtin_add_overflow(a, b, &sum)) return std::nullopt;
+    return sum;
+}
+
+// the range of 'var'; without a known upper bound, var <= var + 0
+Interval Of(const State& state, const std::string& var) {
+    auto it = state.ints.find(var);
+    Interval val = it == state.ints.end() ? Interval{} : it->second;
+    if (!val.hi.bounded()) val.hi = {var, 0};
+    return val;
+}
+
+// a + b, unknown if the addition might wrap around
+Interval Sum(const Interval& a, const Interval& b) {
+    if (a.lo == NoLower || b.lo == NoLower || !a.hi.bounded() || !b.hi.bounded()) return {};
+    if (!a.hi.var.empty() && !b.hi.var.empty()) return {};
+    auto lo = CheckedAdd(a.lo, b.lo), k = CheckedAdd(a.hi.k, b.hi.k);
+    if (!lo || !k || *k == NoUpper) return {};
+    Bound hi{a.hi.var.empty() ? b.hi.var : a.hi.var, *k};
+    if (!hi.var.empty() && *k > 0) return {};  // var + k itself may wrap
+    return {*lo, hi};
+}
+
+Interval Negate(const Interval& a) {
+    if (a.lo == NoLower || !a.hi.bounded() || !a.hi.var.empty() || a.hi.k == NoLower) return {};
+    return {-a.hi.k, {"", -a.lo}};
+}
+
+// only ranges of non-negative constants are multiplied
+Interval Product(const Interval& a, const Interval& b) {
+    if (a.lo < 0 || b.lo < 0 || !a.hi.var.empty() || !b.hi.var.empty() || !a.hi.bounded() || !b.hi.bounded()) return {};
+    int64_t lo, hi;
+    if (__builtin_mul_overflow(a.lo, b.lo, &lo) || __builtin_mul_overflow(a.hi.k, b.hi.k, &hi) || hi == NoUpper) return {};
+    return {lo, {"", hi}};
+}
+
+// a non-negative value divided by a positive constant
+Interval Quotient(const Interval& a, const Interval& b) {
+    if (a.lo < 0 || !b.isConst() || b.lo <= 0) return {};
+    Bound hi = a.hi;
+    if (hi.var.empty() && hi.bounded()) hi.k /= b.lo;
+    return {a.lo / b.lo, hi};
+}
+
+Bound JoinBound(const Bound& a, const State& stateA, const Bound& b, const State& stateB) {
+    if (a == b) return a;
+    if (!a.bounded() || !b.bounded()) return {};
+    if (a.var == b.var) return {a.var, std::max(a.k, b.k)};
+    // c <= var + k on the paths where the constant bound holds
+    auto covers = [](const Bound& c, const State& state, const Bound& sym) {
+        if (!c.var.empty()) return false;
+        auto lo = Of(state, sym.var).lo;
+        if (lo == NoLower) return false;
+        auto min = CheckedAdd(lo, sym.k);
+        return min && c.k <= *min;
+    };
+    if (covers(a, stateA, b)) return b;
+    if (covers(b, stateB, a)) return a;
+    return {};
+}
+
+Interval JoinInterval(const Interval& a, const State& stateA, const Interval& b, const State& stateB) {
+    return {std::min(a.lo, b.lo), JoinBound(a.hi, stateA, b.hi, stateB)};
+}
+
+State Join(const State& a, const State& b) {
+    State out;
+    for (const auto& [var, val] : a.ints)
+        if (auto it = b.ints.find(var); it != b.ints.end())
+            out.ints[var] = JoinInterval(val, a, it->second, b);
+    for (const auto& [var, fact] : a.ptrs)
+        if (auto it = b.ptrs.find(var); it != b.ptrs.end() && it->second.site == fact.site)
+            out.ptrs[var] = {fact.site, JoinInterval(fact.offset, a, it->second.offset, b)};
+    for (const auto& [site, size] : a.sizes)
+        if (auto it = b.sizes.find(site); it != b.sizes.end() && it->second == size) out.sizes[site] = size;
+    for (const auto& [var, cond] : a.conds)
+        if (auto it = b.conds.find(var); it != b.conds.end() && it->second == cond) out.conds[var] = cond;
+    return out;
+}
+
+// give up on whatever still changes, so loops reach a fixed point
+State Widen(const State& old, State next) {
+    auto widen = [](const Interval& before, Interval& after) {
+        if (after.lo != before.lo) after.lo = NoLower;
+        if (after.hi != before.hi) after.hi = {};
+    };
+    for (auto it = next.ints.begin(); it != next.ints.end();) {
+        auto before = old.ints.find(it->first);
+        if (before == old.ints.end()) {
+            it = next.ints.erase(it);
+            continue;
+        }
+        widen(before->second, it->second);
+        ++it;
+    }
+    for (auto it = next.ptrs.begin(); it != next.ptrs.end();) {
+        auto before = old.ptrs.find(it->first);
+        if (before == old.ptrs.end() || before->second.site != it->second.site) {
+            it = next.ptrs.erase(it);
+            continue;
+        }
+        widen(before->second.offset, it->second.offset);
+        ++it;
+    }
+    std::erase_if(next.sizes, [&](const auto& entry) {
+        auto it = old.sizes.find(entry.first);
+        return it == old.sizes.end() || it->second != entry.second;
+    });
+    std::erase_if(next.conds, [&](const auto& entry) {
+        auto it = old.conds.find(entry.first);
+        return it == old.conds.end() || it->second != entry.second;
+    });
+    return next;
+}
+
+// narrow 'state' to the edge on which 'cond' evaluated to 'truth'
+void Refine(State& state, const Compare& cond, bool truth) {
+    BinaryOpType op = cond.op;
+    std::string x = cond.lhs, y = cond.rhs;
+    if (cond.negated) truth = !truth;
+    if (op == Gt || op == Ge) {
+        std::swap(x, y);
+        op = op == Gt ? Lt : Le;
+    }
+    if (op != Lt && op != Le) return;
+    if (!truth) {  // !(x < y) is y <= x, !(x <= y) is y < x
+        std::swap(x, y);
+        op = op == Lt ? Le : Lt;
+    }
+    if (x == y) return;
+    int64_t strict = op == Lt ? 1 : 0;
+
+    // x <= y - strict, against a constant bound of y when there is one
+    Interval valX = Of(state, x), valY = Of(state, y);
+    Bound limit = valY.hi.var.empty() ? valY.hi : Bound{y, 0};
+    if (auto k = CheckedAdd(limit.k, -strict)) {
+        auto& hi = state.ints[x].hi;
+        if (hi.bounded() && hi.var.empty() && limit.var.empty())
+            hi.k = std::min(hi.k, *k);
+        else
+            hi = {limit.var, *k};
+    }
+    // y >= x + strict
+    if (valX.lo != NoLower)
+        if (auto lo = CheckedAdd(valX.lo, strict)) {
+            auto& val = state.ints[y];
+            val.lo = std::max(val.lo, *lo);
+        }
+}
+
+// value <= hi < size, chasing the upper bounds of the variables in 'hi'
+bool Below(const State& state, Bound hi, const Bound& size) {
+    for (int depth = 0; depth < 8 && hi.bounded(); depth++) {
+        if (hi.var == size.var) return hi.k < size.k;
+        if (hi.var.empty()) {
+            auto lo = Of(state, size.var).lo;
+            auto min = lo == NoLower ? std::nullopt : CheckedAdd(lo, size.k);
+            return min && hi.k < *min;
+        }
+        auto it = state.ints.find(hi.var);
+        if (it == state.ints.end() || !it->second.hi.bounded()) return false;
+        auto k = CheckedAdd(it->second.hi.k, hi.k);
+        if (!k) return false;
+        hi = {it->second.hi.var, *k};
+    }
+    return false;
+}
+
+class RangeAnalysis {
+   public:
+    RangeAnalysis(const Function& func) : func(func), pointsTo(func) {
+        for (int site = 0; site < static_cast<int>(pointsTo.sites.size()); site++) siteOf[pointsTo.sites[site].get()] = site;
+        // a callee, or a 'free' of a pointer from memory, can only reach
+        // allocations passed to a call or stored; returning one is harmless
+        auto expose = [&](const std::string& var) {
+            for (int site : pointsTo.pointees(var))
+                if (site != PointsTo::UnknownSite) exposed.insert(site);
+        };
+        for (const auto& bb : func.basicBlocks) {
+            for (const auto& instr : bb->instrs) {
+                if (auto call = dynamic_cast<const Call*>(instr.get()))
+                    for (const auto& arg : call->args) expose(arg);
+                else if (auto store = dynamic_cast<const Store*>(instr.get()))
+                    expose(store->val);
+            }
+        }
+    }
+
+    std::unordered_set<const Instruction*> run() {
+        auto blocks = ReversePostOrder(func);
+        auto preds = Predecessors(func);
+        std::unordered_map<const BasicBlock*, size_t> order;
+        for (size_t i = 0; i < blocks.size(); i++) order[blocks[i]] = i;
+        std::unordered_map<const BasicBlock*, State> in;
+        std::unordered_map<const BasicBlock*, std::vector<std::pair<const BasicBlock*, State>>> out;
+        std::unordered_map<const BasicBlock*, int> visits;
+        // revisit only the successors of blocks whose state changed, in
+        // reverse post-order so that predecessors go first
+        std::set<size_t> worklist;
+        if (!blocks.empty()) worklist.insert(order.at(func.getEntry().get()));
+        while (!worklist.empty()) {
+            auto* bb = blocks[*worklist.begin()];
+            worklist.erase(worklist.begin());
+            std::optional<State> state;
+            if (bb == func.getEntry().get()) state.emplace();
+            for (auto* pred : preds[bb]) {
+                auto it = out.find(pred);
+                if (it == out.end()) continue;  // not reached yet
+                for (const auto& [succ, edge] : it->second)
+                    if (succ == bb) state = state ? Join(*state, edge) : edge;
+            }
+            if (!state) continue;
+            if (auto old = in.find(bb); old != in.end()) {
+                if (++visits[bb] > WidenAfter) *state = Widen(old->second, std::move(*state));
+                if (old->second == *state) continue;
+            }
+            in[bb] = *state;
+            for (const auto& instr : bb->instrs) transfer(*state, *instr);
+            out[bb] = successors(*bb, std::move(*state));
+            for (const auto& succ : bb->successors())
+                if (auto it = order.find(succ.get()); it != order.end()) worklist.insert(it->second);
+        }
+
+        std::unordered_set<const Instruction*> safe;
+        for (auto* bb : blocks) {
+            State state = in.at(bb);
+            for (const auto& instr : bb->instrs) {
+                if (auto load = dynamic_cast<const Load*>(instr.get()); load && inBounds(state, load->ptr))
+                    safe.insert(instr.get());
+                else if (auto store = dynamic_cast<const Store*>(instr.get()); store && inBounds(state, store->ptr))
+                    safe.insert(instr.get());
+                transfer(state, *instr);
+            }
+        }
+        return safe;
+    }
+
+   private:
+    const Function& func;
+    PointsTo pointsTo;
+    std::unordered_map<const Instruction*, int> siteOf;
+    std::unordered_set<int> exposed;
+
+    bool inBounds(const State& state, const std::string& ptr) const {
+        auto fact = state.ptrs.find(ptr);
+        if (fact == state.ptrs.end()) return false;
+        auto size = state.sizes.find(fact->second.site);
+        return size != state.sizes.end() && fact->second.offset.lo >= 0 && Below(state, fact->second.offset.hi, size->second);
+    }
+
+    // 'var' is redefined: forget it and every fact that mentions it
+    static void kill(State& state, const std::string& var) {
+        state.ints.erase(var);
+        state.ptrs.erase(var);
+        state.conds.erase(var);
+        for (auto& [name, val] : state.ints)
+            if (val.hi.var == var) val.hi = {};
+        for (auto& [name, fact] : state.ptrs)
+            if (fact.offset.hi.var == var) fact.offset.hi = {};
+        std::erase_if(state.sizes, [&](const auto& entry) { return entry.second.var == var; });
+        std::erase_if(state.conds, [&](const auto& entry) { return entry.second.lhs == var || entry.second.rhs == var; });
+    }
+
+    static void setInt(State& state, const std::string& dest, Interval val) {
+        kill(state, dest);
+        if (val.hi.var == dest) val.hi = {};
+        if (val.lo != NoLower || val.hi.bounded()) state.ints[dest] = val;
+    }
+
+    static void setPtr(State& state, const std::string& dest, PtrFact fact) {
+        kill(state, dest);
+        if (fact.offset.hi.var == dest) fact.offset.hi = {};
+        state.ptrs[dest] = fact;
+    }
+
+    // the allocation may have been freed
+    static void killSite(State& state, int site) {
+        state.sizes.erase(site);
+        std::erase_if(state.ptrs, [&](const auto& entry) { return entry.second.site == site; });
+    }
+
+    void killExposed(State& state) const {
+        for (int site : exposed) killSite(state, site);
+    }
+
+    void transfer(State& state, const Instruction& instr) const {
+        if (auto c = dynamic_cast<const Constant*>(&instr)) {
+            setInt(state, c->dest->name, {c->val, {"", c->val}});
+        } else if (auto id = dynamic_cast<const Id*>(&instr)) {
+            if (std::dynamic_pointer_cast<PointerType>(id->dest->type)) {
+                auto fact = state.ptrs.find(id->src);
+                if (fact != state.ptrs.end())
+                    setPtr(state, id->dest->name, fact->second);
+                else
+                    kill(state, id->dest->name);
+                return;
+            }
+            auto cond = state.conds.find(id->src);
+            auto copy = cond == state.conds.end() ? std::nullopt : std::optional<Compare>(cond->second);
+            setInt(state, id->dest->name, Of(state, id->src));
+            if (copy) state.conds[id->dest->name] = *copy;
+        } else if (auto bin = dynamic_cast<const BinaryOp*>(&instr)) {
+            Interval lhs = Of(state, bin->lhs->name), rhs = Of(state, bin->rhs->name);
+            switch (bin->op) {
+                case Add: setInt(state, bin->dest->name, Sum(lhs, rhs)); break;
+                case Sub: setInt(state, bin->dest->name, Sum(lhs, Negate(rhs))); break;
+                case Mul: setInt(state, bin->dest->name, Product(lhs, rhs)); break;
+                case Div: setInt(state, bin->dest->name, Quotient(lhs, rhs)); break;
+                case Eq:
+                case Lt:
+                case Gt:
+                case Le:
+                case Ge:
+                    kill(state, bin->dest->name);
+                    state.conds[bin->dest->name] = {bin->op, bin->lhs->name, bin->rhs->name};
+                    break;
+                default: kill(state, bin->dest->name);
+            }
+        } else if (auto un = dynamic_cast<const UnaryOp*>(&instr)) {
+            auto cond = state.conds.find(un->src->name);
+            auto copy = cond == state.conds.end() ? std::nullopt : std::optional<Compare>(cond->second);
+            kill(state, un->dest->name);
+            if (copy && un->op == Not) {
+                copy->negated = !copy->negated;
+                state.conds[un->dest->name] = *copy;
+            }
+        } else if (auto alloc = dynamic_cast<const Alloc*>(&instr)) {
+            int site = siteOf.at(alloc);
+            Interval size = Of(state, alloc->size);
+            Bound exact = size.isConst() ? Bound{"", size.lo} : Bound{alloc->size, 0};
+            killSite(state, site);  // pointers into the previous run of this alloc
+            setPtr(state, alloc->dest->name, {site, {0, {"", 0}}});
+            state.sizes[site] = exact;
+            // allocate() rejects sizes below one
+            auto& val = state.ints[alloc->size];
+            val.lo = std::max<int64_t>(val.lo, 1);
+        } else if (auto ptrAdd = dynamic_cast<const PtrAdd*>(&instr)) {
+            auto fact = state.ptrs.find(ptrAdd->ptr);
+            if (fact != state.ptrs.end())
+                setPtr(state, ptrAdd->dest->name, {fact->second.site, Sum(fact->second.offset, Of(state, ptrAdd->offset))});
+            else
+                kill(state, ptrAdd->dest->name);
+        } else if (auto free = dynamic_cast<const Free*>(&instr)) {
+            for (int site : pointsTo.pointees(free->site)) {
+                if (site == PointsTo::UnknownSite)
+                    killExposed(state);
+                else
+                    killSite(state, site);
+            }
+        } else {
+            if (dynamic_cast<const Call*>(&instr)) killExposed(state);  // the callee may free them
+            for (const auto& def : instr.defs()) kill(state, def);
+        }
+    }
+
+    // the state along each outgoing edge, narrowed by the branch condition
+    static std::vector<std::pair<const BasicBlock*, State>> successors(const BasicBlock& bb, State state) {
+        const Branch* branch = bb.instrs.empty() ? nullptr : dynamic_cast<const Branch*>(bb.instrs.back().get());
+        if (!branch) {
+            std::vector<std::pair<const BasicBlock*, State>> edges;
+            for (const auto& succ : bb.successors()) edges.emplace_back(succ.get(), state);
+            return edges;
+        }
+        State taken = state, notTaken = std::move(state);
+        if (auto cond = taken.conds.find(branch->cond->name); cond != taken.conds.end()) {
+            Compare compare = cond->second;
+            Refine(taken, compare, true);
+            Refine(notTaken, compare, false);
+        }
+        return {{bb.taken.lock().get(), std::move(taken)}, {bb.notTaken.lock().get(), std::move(notTaken)}};
+    }
+};
+
+}  // namespace
+
+std::unordered_set<const ir::Instruction*> SafeAccesses(const ir::Function& func) {
+    bool accesses = false;
+    for (const auto& bb : func.basicBlocks)
+        for (const auto& instr : bb->instrs) accesses |= dynamic_cast<const Load*>(instr.get()) || dynamic_cast<const Store*>(instr.get());
+    if (!accesses) return {};
+    return RangeAnalysis(func).run();
+}
+
+}  // namespace opt
@@ -0,0 +1,349 @@
+#include <Analysis/Liveness.h>
+#include <Codegen/CppEmitter.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+#include <IR/Type.h>
+
+#include <cctype>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace codegen {
+
+namespace {
+
+// heap words are int64_t; bools and pointers are converted on load/store
+const char* Runtime = R"(#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <type_traits>
+
+namespace rt {
+
+using word = int64_t;
+
+[[noreturn]] void die(const std::string& msg) {
+    std::cout.flush();
+    std::cerr << msg << std::endl;
+    std::exit(2);
+}
+
+std::map<word*, int64_t> heap;
+
+word* alloc(int64_t size) {
+    if (size <= 0) die("error: must allocate a positive amount of memory: " + std::to_string(size));
+    word* ptr = new word[size]();  // zeroed, as in HeapManager::allocate
+    heap[ptr] = size;
+    return ptr;
+}
+
+void release(word* ptr) {
+    auto f = heap.find(ptr);
+    if (f == heap.end()) die("Base addr not found in heap");
+    delete[] ptr;
+    heap.erase(f);
+}
+
+word* check(word* ptr, const char* op) {
+    auto greater = heap.upper_bound(ptr);
+    if (greater == heap.begin()) die(std::string(op) + ": Uninitialized heap location and/or illegal offset");
+    auto [base, size] = *std::prev(greater);
+    if (ptr < base || ptr >= base + size) die(std::string(op) + ": Uninitialized heap location and/or illegal offset");
+    return ptr;
+}
+
+template <class T>
+T fromWord(word w) {
+    if constexpr (std::is_pointer_v<T>)
+        return reinterpret_cast<T>(w);
+    else
+        return static_cast<T>(w);
+}
+
+template <class T>
+word toWord(T v) {
+    if constexpr (std::is_pointer_v<T>)
+        return reinterpret_cast<word>(v);
+    else
+        return static_cast<word>(v);
+}
+
+template <class T>
+T load(word* ptr) { return fromWord<T>(*check(ptr, "Load")); }
+
+template <class T>
+void store(word* ptr, T val) { *check(ptr, "Store") = toWord(val); }
+
+// arithmetic wraps around like the interpreter's
+inline int64_t add(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b)); }
+inline int64_t sub(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b)); }
+inline int64_t mul(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b)); }
+inline int64_t div(int64_t a, int64_t b) {
+    if (b == 0) die("error: division by zero");
+    if (b == -1) return sub(0, a);
+    return a / b;
+}
+
+void print(int64_t v) { std::cout << v << ' '; }
+void print(bool v) { std::cout << (v ? "true" : "false") << ' '; }
+void print(word*) { std::cout << "0x2a" << ' '; }
+
+int64_t parseInt(const char* arg) {
+    const char* digits = arg + (arg[0] == '-');
+    if (!*digits || std::strspn(digits, "0123456789") != std::strlen(digits)) {
+        if (!std::strcmp(arg, "true") || !std::strcmp(arg, "false")) die(std::string("error: invalid argument type, should be bool") + arg);
+        die(std::string("error: invalid argument: ") + arg);
+    }
+    return std::strtoll(arg, nullptr, 10);
+}
+
+bool parseBool(const char* arg) {
+    if (!std::strcmp(arg, "true")) return true;
+    if (!std::strcmp(arg, "false")) return false;
+    die(std::string("error: invalid argument type, should be int: ") + arg);
+}
+
+}  // namespace rt
+)";
+
+// Bril names allow characters C++ identifiers do not: keep [a-zA-Z0-9],
+// double '_' and hex-escape the rest, so distinct names stay distinct
+std::string Mangle(const std::string& prefix, const std::string& name) {
+    std::string out = prefix;
+    for (unsigned char c : name) {
+        if (std::isalnum(c))
+            out += static_cast<char>(c);
+        else if (c == '_')
+            out += "__";
+        else
+            out += std::format("_x{:02x}", c);
+    }
+    return out;
+}
+
+std::string Var(const std::string& name) {
+    return Mangle("v_", name);
+}
+
+// set once the variable of the same name is assigned
+std::string Defined(const std::string& name) {
+    return Mangle("d_", name);
+}
+
+std::string Func(const std::string& name) {
+    return Mangle("f_", name);
+}
+
+std::string CppType(const ir::TypePtr& type) {
+    if (!type || std::dynamic_pointer_cast<ir::IntType>(type)) return "int64_t";
+    if (std::dynamic_pointer_cast<ir::BoolType>(type)) return "bool";
+    return "rt::word*";
+}
+
+std::string Literal(const ir::TypePtr& type, int64_t val) {
+    if (std::dynamic_pointer_cast<ir::BoolType>(type)) return val ? "true" : "false";
+    if (val == std::numeric_limits<int64_t>::min()) return "INT64_MIN";
+    return std::format("INT64_C({})", val);
+}
+
+class FunctionEmitter {
+   public:
+    FunctionEmitter(ir::Function& func) : func(func) {}
+
+    std::string signature() const {
+        std::string sig = std::format("{} {}(", func.getRetType() ? CppType(func.getRetType()) : "void", Func(func.name));
+        for (size_t i = 0; i < func.args.size(); i++)
+            sig += std::format("{}{} {}", i ? ", " : "", CppType(func.args[i]->type), Var(func.args[i]->name));
+        return sig + ")";
+    }
+
+    void emit(std::ostream& os) {
+        collectTypes();
+        if (func.getEntry()) {  // read before assigned on some path: trap like the interpreter
+            opt::Liveness liveness(func);
+            for (const auto& name : liveness.liveIn(func.getEntry().get()))
+                if (!isArg(name)) undefined.insert(name);
+        }
+        for (size_t i = 0; i < func.basicBlocks.size(); i++) index[func.basicBlocks[i].get()] = i;
+        std::vector<std::string> bodies;
+        for (size_t i = 0; i < func.basicBlocks.size(); i++) bodies.push_back(block(i));
+
+        os << signature() << " {\n";
+        for (const auto& name : locals) os << std::format("    {} {} = {{}};\n", CppType(types.at(name)), Var(name));
+        for (const auto& name : locals)
+            if (undefined.contains(name)) os << std::format("    bool {} = false;\n", Defined(name));
+        if (func.getEntry() && func.getEntry() != func.basicBlocks.front()) os << "    goto " << gotoLabel(func.getEntry().get()) << ";\n";
+        for (size_t i = 0; i < bodies.size(); i++) {
+            if (referenced.contains(i)) os << std::format("bb{}:;\n", i);
+            os << bodies[i];
+        }
+        if (bodies.empty()) os << (func.getRetType() ? "    return {};\n" : "    return;\n");
+        os << "}\n";
+    }
+
+   private:
+    ir::Function& func;
+    std::unordered_map<std::string, ir::TypePtr> types;
+    std::vector<std::string> locals;  // non-argument variables in order of appearance
+    std::unordered_map<const ir::BasicBlock*, size_t> index;
+    std::unordered_set<size_t> referenced;
+    std::unordered_set<std::string> undefined;  // locals that may be read before assigned
+
+    bool isArg(const std::string& name) const {
+        for (const auto& arg : func.args)
+            if (arg->name == name) return true;
+        return false;
+    }
+
+    void collectTypes() {
+        auto record = [this](const ir::Variable& var) {
+            auto [it, inserted] = types.emplace(var.name, var.type);
+            if (inserted && !isArg(var.name)) locals.push_back(var.name);
+            if (!inserted && !it->second)
+                it->second = var.type;
+            else if (!inserted && !(*it->second == *var.type))
+                throw std::runtime_error(std::format("error: bril2cpp: variable {} in @{} has more than one type", var.name, func.name));
+        };
+        for (const auto& arg : func.args) record(*arg);
+        for (const auto& bb : func.basicBlocks) {
+            for (const auto& instr : bb->instrs) {
+                for (const auto& var : instr->liveOut()) record(var);
+                for (const auto& name : instr->uses())  // used before (or without) an assignment
+                    if (types.emplace(name, nullptr).second) locals.push_back(name);
+            }
+        }
+    }
+
+    std::string gotoLabel(const ir::BasicBlock* bb) {
+        referenced.insert(index.at(bb));
+        return std::format("bb{}", index.at(bb));
+    }
+
+    // leave the block towards 'succ', nothing if it is laid out next
+    std::string leave(const ir::BasicBlock* succ, size_t i) {
+        if (!succ) return func.getRetType() ? "    return {};\n" : "    return;\n";
+        if (index.at(succ) == i + 1) return "";
+        return "    goto " + gotoLabel(succ) + ";\n";
+    }
+
+    std::string block(size_t i) {
+        const auto& bb = func.basicBlocks[i];
+        std::ostringstream os;
+        for (const auto& instr : bb->instrs) {
+            for (const auto& name : instr->uses())
+                if (undefined.contains(name)) os << std::format("    if (!{}) rt::die(\"error: undefined variable {}\");\n", Defined(name), name);
+            os << instruction(*instr, *bb, i);
+            if (instr->isTerminator()) return os.str();
+            for (const auto& name : instr->defs())
+                if (undefined.contains(name)) os << std::format("    {} = true;\n", Defined(name));
+        }
+        os << leave(bb->notTaken.lock().get(), i);
+        return os.str();
+    }
+
+    std::string binOp(const ir::BinaryOp& bin) {
+        std::string lhs = Var(bin.lhs->name), rhs = Var(bin.rhs->name);
+        switch (bin.op) {
+            case ir::Add: return std::format("rt::add({}, {})", lhs, rhs);
+            case ir::Sub: return std::format("rt::sub({}, {})", lhs, rhs);
+            case ir::Mul: return std::format("rt::mul({}, {})", lhs, rhs);
+            case ir::Div: return std::format("rt::div({}, {})", lhs, rhs);
+            case ir::And: return std::format("{} && {}", lhs, rhs);
+            case ir::Or: return std::format("{} || {}", lhs, rhs);
+            case ir::Eq: return std::format("{} == {}", lhs, rhs);
+            case ir::Lt: return std::format("{} < {}", lhs, rhs);
+            case ir::Gt: return std::format("{} > {}", lhs, rhs);
+            case ir::Le: return std::format("{} <= {}", lhs, rhs);
+            case ir::Ge: return std::format("{} >= {}", lhs, rhs);
+            default: throw std::runtime_error("error: bril2cpp: invalid binary operator");
+        }
+    }
+
+    std::string instruction(ir::Instruction& instr, ir::BasicBlock& bb, size_t i) {
+        if (dynamic_cast<ir::Label*>(&instr) || dynamic_cast<ir::Nop*>(&instr)) {
+            return "";
+        } else if (auto c = dynamic_cast<ir::Constant*>(&instr)) {
+            return std::format("    {} = {};\n", Var(c->dest->name), Literal(c->dest->type, c->val));
+        } else if (auto bin = dynamic_cast<ir::BinaryOp*>(&instr)) {
+            return std::format("    {} = {};\n", Var(bin->dest->name), binOp(*bin));
+        } else if (auto un = dynamic_cast<ir::UnaryOp*>(&instr)) {
+            return std::format("    {} = !{};\n", Var(un->dest->name), Var(un->src->name));
+        } else if (auto id = dynamic_cast<ir::Id*>(&instr)) {
+            return std::format("    {} = {};\n", Var(id->dest->name), Var(id->src));
+        } else if (dynamic_cast<ir::Jump*>(&instr)) {
+            return leave(bb.taken.lock().get(), i);
+        } else if (auto br = dynamic_cast<ir::Branch*>(&instr)) {
+            auto taken = bb.taken.lock().get(), notTaken = bb.notTaken.lock().get();
+            if (index.at(taken) == i + 1 && taken != notTaken)
+                return std::format("    if (!{}) goto {};\n", Var(br->cond->name), gotoLabel(notTaken));
+            return std::format("    if ({}) goto {};\n", Var(br->cond->name), gotoLabel(taken)) + leave(notTaken, i);
+        } else if (auto call = dynamic_cast<ir::Call*>(&instr)) {
+            std::string args;
+            for (size_t a = 0; a < call->args.size(); a++) args += (a ? ", " : "") + Var(call->args[a]);
+            std::string expr = std::format("{}({})", Func(call->funcName), args);
+            if (call->dest) return std::format("    {} = {};\n", Var(call->dest->name), expr);
+            return "    " + expr + ";\n";
+        } else if (auto ret = dynamic_cast<ir::Return*>(&instr)) {
+            if (ret->val) return std::format("    return {};\n", Var(*ret->val));
+            return func.getRetType() ? "    return {};\n" : "    return;\n";
+        } else if (auto print = dynamic_cast<ir::Print*>(&instr)) {
+            std::string out = "    ";
+            for (const auto& arg : print->args) out += std::format("rt::print({}); ", Var(arg));
+            return out + "std::cout << '\\n';\n";
+        } else if (auto alloc = dynamic_cast<ir::Alloc*>(&instr)) {
+            return std::format("    {} = rt::alloc({});\n", Var(alloc->dest->name), Var(alloc->size));
+        } else if (auto free = dynamic_cast<ir::Free*>(&instr)) {
+            return std::format("    rt::release({});\n", Var(free->site));
+        } else if (auto load = dynamic_cast<ir::Load*>(&instr)) {
+            if (!load->checked) return std::format("    {} = rt::fromWord<{}>(*{});\n", Var(load->dest->name), CppType(load->dest->type), Var(load->ptr));
+            return std::format("    {} = rt::load<{}>({});\n", Var(load->dest->name), CppType(load->dest->type), Var(load->ptr));
+        } else if (auto store = dynamic_cast<ir::Store*>(&instr)) {
+            if (!store->checked) return std::format("    *{} = rt::toWord({});\n", Var(store->ptr), Var(store->val));
+            return std::format("    rt::store({}, {});\n", Var(store->ptr), Var(store->val));
+        } else if (auto ptrAdd = dynamic_cast<ir::PtrAdd*>(&instr)) {
+            return std::format("    {} = {} + {};\n", Var(ptrAdd->dest->name), Var(ptrAdd->ptr), Var(ptrAdd->offset));
+        }
+        throw std::runtime_error("error: bril2cpp: unsupported instruction: " + (std::stringstream() << instr).str());
+    }
+};
+
+}  // namespace
+
+void EmitCpp(ir::Program& prog, std::ostream& os) {
+    if (!prog.mainFunc) throw std::runtime_error("error: main function not found");
+    os << "// generated by bril2cpp\n" << Runtime << "\n";
+    for (const auto& func : prog.functions) os << FunctionEmitter(*func).signature() << ";\n";
+    for (const auto& func : prog.functions) {
+        os << "\n";
+        FunctionEmitter(*func).emit(os);
+    }
+
+    const auto& mainArgs = prog.mainFunc->args;
+    os << "\nint main(int argc, char** argv) {\n";
+    os << std::format("    if (argc != {}) rt::die(\"error: mismatched main argument arity\");\n", mainArgs.size() + 1);
+    std::string args;
+    for (size_t i = 0; i < mainArgs.size(); i++) {
+        bool isBool = std::dynamic_pointer_cast<ir::BoolType>(mainArgs[i]->type) != nullptr;
+        args += std::format("{}rt::{}(argv[{}])", i ? ", " : "", isBool ? "parseBool" : "parseInt", i + 1);
+    }
+    os << std::format("    {}({});\n", Func(prog.mainFunc->name), args);
+    os << "    return 0;\n}\n";
+}
+
+}  // namespace codegen
@@ -24,10 +24,17 @@ ctrlStatus BasicBlock::execute(varContext &vars, HeapManager &heap) {
     ctrlStatus status = false;  // default fall-through for empty BB
     for (const auto &instr : instrs) {
         status = instr->execute(vars, heap);
-        if (instr->isTerminator())
+        if (instr->isTerminator() || status.tailCallValid())
             break;
     }
     return status;
 }
 
+std::vector<BBPtr> BasicBlock::successors() const {
+    std::vector<BBPtr> succs;
+    if (auto t = taken.lock()) succs.push_back(t);
+    if (auto nt = notTaken.lock(); nt && (succs.empty() || nt != succs.front())) succs.push_back(nt);
+    return succs;
+}
+
 }  // namespace ir
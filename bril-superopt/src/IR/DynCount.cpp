@@ -0,0 +1,59 @@
+#include <IR/BasicBlock.h>
+#include <IR/DynCount.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+
+#include <algorithm>
+#include <format>
+#include <ostream>
+
+namespace ir {
+
+namespace {
+
+// add 'runs' executions of 'instr' to its opcodes; returns the instructions counted
+uint64_t Attribute(const Instruction& instr, uint64_t runs, std::map<std::string, uint64_t>& byOpcode) {
+    if (auto fused = dynamic_cast<const Fused*>(&instr))
+        return Attribute(*fused->first, runs, byOpcode) + Attribute(*fused->second, runs, byOpcode);
+    if (dynamic_cast<const Label*>(&instr)) return 0;
+    byOpcode[OpcodeName(instr)] += runs;
+    return runs;
+}
+
+void Histogram(std::ostream& os, const std::string& kind, std::vector<std::pair<std::string, uint64_t>> counts, uint64_t total) {
+    std::ranges::stable_sort(counts, [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+    for (const auto& [name, count] : counts)
+        if (count) os << std::format("{}: {} count={} ({:.1f}%)\n", kind, name, count, total ? 100.0 * count / total : 0.0);
+}
+
+}  // namespace
+
+DynCount::DynCount(const Program& prog) {
+    for (const auto& func : prog.functions) {
+        uint64_t count = 0;
+        for (const auto& bb : func->basicBlocks)
+            if (bb->runs)
+                for (const auto& instr : bb->instrs) count += Attribute(*instr, bb->runs, byOpcode);
+        byFunction.emplace_back("@" + func->name, count);
+        total += count;
+    }
+}
+
+uint64_t InstructionCount(const BasicBlock& bb) {
+    std::map<std::string, uint64_t> byOpcode;
+    uint64_t count = 0;
+    for (const auto& instr : bb.instrs) count += Attribute(*instr, 1, byOpcode);
+    return count;
+}
+
+void DynCount::report(std::ostream& os) const {
+    os << std::format("total_dyn_inst: {}\n", total);
+}
+
+void DynCount::histogram(std::ostream& os) const {
+    Histogram(os, "opcode", {byOpcode.begin(), byOpcode.end()}, total);
+    Histogram(os, "function", byFunction, total);
+}
+
+}  // namespace ir
@@ -91,6 +91,14 @@ Function::Function(const json& funcJson) {
     ConstructCFG(instrs);
 }
 
+std::string Function::blockName(const BasicBlock& bb) const {
+    if (!bb.instrs.empty())
+        if (auto label = dynamic_cast<const Label*>(bb.instrs.front().get())) return "." + label->name;
+    for (size_t i = 0; i < basicBlocks.size(); i++)
+        if (basicBlocks[i].get() == &bb) return "#" + std::to_string(i);
+    return "?";
+}
+
 std::ostream& operator<<(std::ostream& os, const Function& func) {
     os << "@" << func.name;
     if (func.args.size() > 0) {
@@ -113,15 +121,103 @@ std::ostream& operator<<(std::ostream& os, const Function& func) {
     return os;
 }
 
+// a call is in tail position when the block returns its result right after it
+void Function::MarkTailCalls() {
+    for (const auto& bb : this->basicBlocks) {
+        for (size_t i = 0; i < bb->instrs.size(); i++) {
+            auto call = std::dynamic_pointer_cast<Call>(bb->instrs[i]);
+            if (!call) continue;
+            auto ret = i + 1 < bb->instrs.size() ? std::dynamic_pointer_cast<Return>(bb->instrs[i + 1]) : nullptr;
+            call->tail = ret && (ret->val ? call->dest && call->dest->name == *ret->val : !call->dest);
+        }
+    }
+}
+
+bool Function::enterTier() {
+    if (!tier) return false;
+    if (native) return true;
+    return ++calls == tier->callThreshold && tier->promote(*this);
+}
+
+namespace {
+
+// BasicBlock::execute, publishing each instruction before it runs
+ctrlStatus ExecuteSampled(BasicBlock& bb, varContext& vars, HeapManager& heap, Sampler& sampler) {
+    ctrlStatus status = false;
+    for (const auto& instr : bb.instrs) {
+        sampler.current.store(instr.get(), std::memory_order_relaxed);
+        status = instr->execute(vars, heap);
+        if (instr->isTerminator() || status.tailCallValid()) break;
+    }
+    return status;
+}
+
+}  // namespace
+
 std::optional<int64_t> Function::execute(varContext& vars, HeapManager& heap) {
+    if (sampler) return counting ? interpret<true, true>(vars, heap) : interpret<false, true>(vars, heap);
+    return counting ? interpret<true, false>(vars, heap) : interpret<false, false>(vars, heap);
+}
+
+template <bool Counting, bool Sampling>
+std::optional<int64_t> Function::interpret(varContext& vars, HeapManager& heap) {
+    if (enterTier()) return native(vars, heap);
+    // the call instruction of the caller, published again on return
+    Sampler* sampler = this->sampler;
+    const Instruction* caller = nullptr;
+    if constexpr (Sampling) caller = sampler->current.load(std::memory_order_relaxed);
+    // memoized activations of this tail-call chain, all returning the same value
+    std::vector<std::pair<Function*, MemoTable::Key>> pending;
+    if (memo) {
+        auto key = MemoTable::makeKey(*this, vars);
+        if (auto hit = memo->lookup(*this, key)) return *hit;
+        pending.emplace_back(this, std::move(key));
+    }
+    Function* curFunc = this;
     BBPtr curBB = this->entryBB;
+    const BasicBlock* prevBB = nullptr;
     std::optional<int64_t> retVal;
     do {
-        ctrlStatus nextStatus = curBB->execute(vars, heap);
+        if (curFunc->pairs) curFunc->pairs->enter(prevBB, curBB.get());
+        if constexpr (Counting) curBB->runs++;
+        if constexpr (Sampling) sampler->poll();
+        ctrlStatus nextStatus = Sampling ? ExecuteSampled(*curBB, vars, heap, *sampler) : curBB->execute(vars, heap);
+        if (nextStatus.tailCallValid()) {  // continue in the callee with a fresh frame
+            const Call* call = nextStatus.getTailCall();
+            vars = call->bindArgs(vars);
+            curFunc = call->func.lock().get();
+            if (curFunc->enterTier()) {
+                retVal = curFunc->native(vars, heap);
+                break;
+            }
+            if (curFunc->memo) {
+                auto key = MemoTable::makeKey(*curFunc, vars);
+                if (auto hit = curFunc->memo->lookup(*curFunc, key)) {
+                    retVal = *hit;
+                    break;
+                }
+                pending.emplace_back(curFunc, std::move(key));
+            }
+            curBB = curFunc->entryBB;
+            prevBB = nullptr;
+            continue;
+        }
         bool isRet = nextStatus.retValid();
         if (isRet) retVal = nextStatus.getRet();
-        curBB = isRet ? nullptr : (nextStatus.getTaken() ? curBB->taken.lock() : curBB->notTaken.lock());
+        BBPtr nextBB = isRet ? nullptr : (nextStatus.getTaken() ? curBB->taken.lock() : curBB->notTaken.lock());
+        if constexpr (Counting)
+            if (!isRet) (nextStatus.getTaken() ? curBB->takenRuns : curBB->notTakenRuns)++;
+        if (curFunc->tracer && nextBB) nextBB = curFunc->tracer->transition(*curFunc, *curBB, std::move(nextBB), vars, heap);
+        if (curFunc->tier && nextBB && curBB->loopLatch && nextBB->loopHeader) {
+            if (!curFunc->native && ++curFunc->backEdges == curFunc->tier->backEdgeThreshold) curFunc->tier->promote(*curFunc);
+            // a hot loop in a compiled function: move over rather than wait for the next call
+            if (curFunc->native && curFunc->tier->enterLoop(*curFunc, *nextBB, vars, heap, retVal)) break;
+        }
+        prevBB = curBB.get();
+        curBB = nextBB;
     } while (curBB);
+    for (auto& [func, key] : pending) func->memo->insert(*func, std::move(key), retVal);
+    if constexpr (Sampling) sampler->current.store(caller, std::memory_order_relaxed);
     return retVal;
 }
 
@@ -1,20 +1,29 @@
 #include <IR/Heap.h>
 
+#include <algorithm>
 #include <format>
 #include <stdexcept>
 
 namespace ir {
 
+HeapManager::~HeapManager() {
+    for (auto [ptr, size] : heap) delete[] ptr;
+}
+
 int64_t *HeapManager::allocate(int size) {
     if (size <= 0) throw std::runtime_error("error: must allocate a positive amount of memory: " + std::to_string(size));
-    int64_t *ptr = new int64_t[size];
+    // zeroed, so that reading a word never stored is the same in every engine and run
+    int64_t *ptr = new int64_t[size]();
     heap[ptr] = size;
+    liveWords += size;
+    peakWords = std::max(peakWords, liveWords);
     return ptr;
 }
 
 void HeapManager::deallocate(int64_t *ptr) {
     if (auto f = heap.find(ptr); f != heap.end()) {
         delete[] ptr;
+        liveWords -= f->second;
         heap.erase(f);
     } else {
         throw std::runtime_error("Base addr not found in heap: " + std::format("0x{:x}", reinterpret_cast<uintptr_t>(ptr)));
@@ -1,6 +1,7 @@
 #include <IR/Function.h>
 #include <IR/Instruction.h>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <nlohmann/json.hpp>
@@ -16,10 +17,34 @@ std::ostream& operator<<(std::ostream& os, const Instruction& instr) {
     return instr.print(os);
 }
 
+static thread_local std::ostream* output = nullptr;
+
+std::ostream& Output() {
+    return output ? *output : std::cout;
+}
+
+void SetOutput(std::ostream* os) {
+    output = os;
+}
+
+static void CheckAccess(HeapManager& heap, int64_t* addr, const char* op) {
+    if (heap.boundCheck(addr) == false)
+        throw std::runtime_error(std::format("{}: Uninitialized heap location and/or illegal offset: 0x{:x}", op, reinterpret_cast<uintptr_t>(addr)));
+}
+
+static VarPtr RenameVar(const VarPtr& var, const Renamer& rename) {
+    if (!var) return nullptr;
+    return std::make_shared<Variable>(rename(var->name), var->type);
+}
+
 std::ostream& Label::print(std::ostream& os) const {
     return os << "." << this->name << ":";
 }
 
+InstPtr Label::clone([[maybe_unused]] const Renamer& var, const Renamer& label) const {
+    return std::make_shared<Label>(label(name));
+}
+
 std::ostream& Constant::print(std::ostream& os) const {
     if (auto intType = std::dynamic_pointer_cast<IntType>(this->dest->type)) {
         return os << *this->dest << " = const " << this->val << ";";
@@ -32,6 +57,14 @@ std::ostream& Constant::print(std::ostream& os) const {
     }
 }
 
+InstPtr Constant::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<Constant>(RenameVar(dest, var), val);
+}
+
+bool Constant::isPure() const {
+    return true;
+}
+
 ctrlStatus Constant::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     vars[dest->name] = RuntimeVal(dest->type, val);
     return false;
@@ -41,36 +74,20 @@ std::vector<Variable> Constant::liveOut() {
     return {*dest};
 }
 
+std::vector<std::string> Constant::defs() const {
+    return {dest->name};
+}
+
 std::ostream& BinaryOp::print(std::ostream& os) const {
-    return os << *this->dest << " = " << [&]() {
-        switch (this->op) {
-            case BinaryOpType::Add:
-                return "add";
-            case BinaryOpType::Sub:
-                return "sub";
-            case BinaryOpType::Mul:
-                return "mul";
-            case BinaryOpType::Div:
-                return "div";
-            case BinaryOpType::And:
-                return "and";
-            case BinaryOpType::Or:
-                return "or";
-            case BinaryOpType::Eq:
-                return "eq";
-            case BinaryOpType::Lt:
-                return "lt";
-            case BinaryOpType::Gt:
-                return "gt";
-            case BinaryOpType::Le:
-                return "le";
-            case BinaryOpType::Ge:
-                return "ge";
-            default:
-                throw std::runtime_error("Invalid BinaryOpType: " + std::to_string(static_cast<int>(this->op)));
-        }
-    }() << " " << this->lhs->name
-              << " " << this->rhs->name << ";";
+    return os << *this->dest << " = " << BinOpToStr(this->op) << " " << this->lhs->name << " " << this->rhs->name << ";";
+}
+
+InstPtr BinaryOp::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<BinaryOp>(op, RenameVar(dest, var), RenameVar(lhs, var), RenameVar(rhs, var));
+}
+
+bool BinaryOp::isPure() const {
+    return op != BinaryOpType::Div;  // div traps on zero
 }
 
 std::vector<Variable> BinaryOp::liveIn() {
@@ -81,48 +98,18 @@ std::vector<Variable> BinaryOp::liveOut() {
     return {*dest};
 }
 
+std::vector<std::string> BinaryOp::uses() const {
+    return {lhs->name, rhs->name};
+}
+
+std::vector<std::string> BinaryOp::defs() const {
+    return {dest->name};
+}
+
 ctrlStatus BinaryOp::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     int64_t lhsVal = vars[this->lhs->name].value;
     int64_t rhsVal = vars[this->rhs->name].value;
-    int64_t result;
-    switch (op) {
-        case Add:
-            result = lhsVal + rhsVal;
-            break;
-        case Sub:
-            result = lhsVal - rhsVal;
-            break;
-        case Mul:
-            result = lhsVal * rhsVal;
-            break;
-        case Div:
-            result = lhsVal / rhsVal;
-            break;
-        case And:
-            result = lhsVal & rhsVal;
-            break;
-        case Or:
-            result = lhsVal | rhsVal;
-            break;
-        case Eq:
-            result = lhsVal == rhsVal;
-            break;
-        case Lt:
-            result = lhsVal < rhsVal;
-            break;
-        case Gt:
-            result = lhsVal > rhsVal;
-            break;
-        case Le:
-            result = lhsVal <= rhsVal;
-            break;
-        case Ge:
-            result = lhsVal >= rhsVal;
-            break;
-        default:
-            throw std::runtime_error("Invalid binary operator");
-    }
-    vars[dest->name] = RuntimeVal(dest->type, result);
+    vars[dest->name] = RuntimeVal(dest->type, EvalBinOp(op, lhsVal, rhsVal));
     return false;  // return false for fall-through
 }
 
@@ -138,24 +125,40 @@ std::ostream& UnaryOp::print(std::ostream& os) const {
               << ";";
 }
 
+InstPtr UnaryOp::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<UnaryOp>(op, RenameVar(dest, var), RenameVar(src, var));
+}
+
+bool UnaryOp::isPure() const {
+    return true;
+}
+
 ctrlStatus UnaryOp::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     int64_t srcVal = vars[this->src->name].value;
-    int64_t result;
-    switch (op) {
-        case Not:
-            result = !srcVal;
-            break;
-        default:
-            throw std::runtime_error("Invalid unary operator");
-    }
-    vars[dest->name] = RuntimeVal(dest->type, result);
+    vars[dest->name] = RuntimeVal(dest->type, EvalUnOp(op, srcVal));
     return false;  // return false for fall-through
 }
 
+std::vector<Variable> UnaryOp::liveOut() {
+    return {*dest};
+}
+
+std::vector<std::string> UnaryOp::uses() const {
+    return {src->name};
+}
+
+std::vector<std::string> UnaryOp::defs() const {
+    return {dest->name};
+}
+
 std::ostream& Jump::print(std::ostream& os) const {
     return os << "jmp ." << this->target << ";";
 }
 
+InstPtr Jump::clone([[maybe_unused]] const Renamer& var, const Renamer& label) const {
+    return std::make_shared<Jump>(label(target));
+}
+
 bool Jump::isTerminator() const {
     return true;
 }
@@ -168,6 +171,10 @@ std::ostream& Branch::print(std::ostream& os) const {
     return os << "br " << this->cond->name << " ." << this->ifTrue << " ." << this->ifFalse << ";";
 }
 
+InstPtr Branch::clone(const Renamer& var, const Renamer& label) const {
+    return std::make_shared<Branch>(RenameVar(cond, var), label(ifTrue), label(ifFalse));
+}
+
 bool Branch::isTerminator() const {
     return true;
 }
@@ -180,6 +187,10 @@ std::vector<Variable> Branch::liveIn() {
     return {*cond};
 }
 
+std::vector<std::string> Branch::uses() const {
+    return {cond->name};
+}
+
 std::ostream& Call::print(std::ostream& os) const {
     if (this->dest) os << *this->dest << " = ";
     os << "call @" << this->funcName;
@@ -187,16 +198,31 @@ std::ostream& Call::print(std::ostream& os) const {
     return os << ";";
 }
 
+InstPtr Call::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    std::vector<std::string> newArgs;
+    for (const auto& arg : args) newArgs.push_back(var(arg));
+    auto call = std::make_shared<Call>(RenameVar(dest, var), funcName, std::move(newArgs));
+    call->func = func;
+    for (const auto& arg : argsVar) call->argsVar.push_back(RenameVar(arg, var));
+    return call;
+}
+
 ctrlStatus Call::execute(varContext& vars, HeapManager& heap) {
+    if (tail) return this;  // the enclosing Function::execute reuses its frame
+    varContext newVars = bindArgs(vars);
+    std::optional<int64_t> ret = this->func.lock()->execute(newVars, heap);
+    if (ret && dest) vars[dest->name] = RuntimeVal(dest->type, *ret);
+    return false;
+}
+
+varContext Call::bindArgs(varContext& vars) const {
     varContext newVars;
     auto func = this->func.lock();
     // construct newVars for args
     for (size_t i = 0; i < args.size(); ++i) {
         newVars[func->args[i]->name] = vars[this->args[i]];
     }
-    std::optional<int64_t> ret = func->execute(newVars, heap);
-    if (ret) vars[dest->name] = RuntimeVal(dest->type, *ret);
-    return false;
+    return newVars;
 }
 
 std::vector<Variable> Call::liveIn() {
@@ -210,10 +236,23 @@ std::vector<Variable> Call::liveOut() {
     return {};
 }
 
+std::vector<std::string> Call::uses() const {
+    return args;
+}
+
+std::vector<std::string> Call::defs() const {
+    if (this->dest) return {dest->name};
+    return {};
+}
+
 std::ostream& Return::print(std::ostream& os) const {
     return os << "ret" << (this->val ? " " + this->val.value() : "") << ";";
 }
 
+InstPtr Return::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<Return>(val ? std::optional<std::string>(var(*val)) : std::nullopt);
+}
+
 bool Return::isTerminator() const {
     return true;
 }
@@ -225,36 +264,84 @@ ctrlStatus Return::execute(varContext& vars, [[maybe_unused]] HeapManager& heap)
         return std::optional<int64_t>(std::nullopt);
 }
 
+std::vector<std::string> Return::uses() const {
+    if (val) return {*val};
+    return {};
+}
+
 std::ostream& Print::print(std::ostream& os) const {
     os << "print";
     for (const auto& arg : this->args) os << " " << arg;
     return os << ";";
 }
 
+InstPtr Print::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    std::vector<std::string> newArgs;
+    for (const auto& arg : args) newArgs.push_back(var(arg));
+    return std::make_shared<Print>(std::move(newArgs));
+}
+
 ctrlStatus Print::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
+    std::ostream& os = Output();
     for (const auto& arg : this->args)
-        std::cout << vars.at(arg).toString() << ' ';
-    std::cout << std::endl;
+        os << vars.at(arg).toString() << ' ';
+    os << std::endl;
     return false;
 }
 
+std::vector<std::string> Print::uses() const {
+    return args;
+}
+
 std::ostream& Id::print(std::ostream& os) const {
     return os << *this->dest << " = id " << this->src << ";";
 }
 
+InstPtr Id::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<Id>(RenameVar(dest, var), var(src));
+}
+
+bool Id::isPure() const {
+    return true;
+}
+
 ctrlStatus Id::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     vars[dest->name] = RuntimeVal(dest->type, vars[src].value);
     return false;
 }
 
+std::vector<Variable> Id::liveOut() {
+    return {*dest};
+}
+
+std::vector<std::string> Id::uses() const {
+    return {src};
+}
+
+std::vector<std::string> Id::defs() const {
+    return {dest->name};
+}
+
 std::ostream& Nop::print(std::ostream& os) const {
     return os << "nop;";
 }
 
+InstPtr Nop::clone([[maybe_unused]] const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<Nop>();
+}
+
+bool Nop::isPure() const {
+    return true;
+}
+
 std::ostream& Alloc::print(std::ostream& os) const {
     return os << *this->dest << " = alloc " << this->size << ";";
 }
 
+InstPtr Alloc::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<Alloc>(RenameVar(dest, var), var(size));
+}
+
 ctrlStatus Alloc::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     int64_t runtimeSize = vars[size].value;
     int64_t* ptr = heap.allocate(runtimeSize);
@@ -262,50 +349,204 @@ ctrlStatus Alloc::execute(varContext& vars, [[maybe_unused]] HeapManager& heap)
     return false;
 }
 
+std::vector<Variable> Alloc::liveOut() {
+    return {*dest};
+}
+
+std::vector<std::string> Alloc::uses() const {
+    return {size};
+}
+
+std::vector<std::string> Alloc::defs() const {
+    return {dest->name};
+}
+
 std::ostream& Free::print(std::ostream& os) const {
     return os << "free " << this->site << ";";
 }
 
+InstPtr Free::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<Free>(var(site));
+}
+
 ctrlStatus Free::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     int64_t* ptr = reinterpret_cast<int64_t*>(vars[site].value);
     heap.deallocate(ptr);
     return false;
 }
 
+std::vector<std::string> Free::uses() const {
+    return {site};
+}
+
 std::ostream& Load::print(std::ostream& os) const {
     return os << *this->dest << " = load " << this->ptr << ";";
 }
 
+InstPtr Load::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<Load>(RenameVar(dest, var), var(ptr));
+}
+
 ctrlStatus Load::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     int64_t* addr = reinterpret_cast<int64_t*>(vars[ptr].value);
-    if (heap.boundCheck(addr) == false)
-        throw std::runtime_error(std::format("Load: Uninitialized heap location and/or illegal offset: 0x{:x}", reinterpret_cast<uintptr_t>(addr)));
+    if (checked) CheckAccess(heap, addr, "Load");
     vars[dest->name] = RuntimeVal(dest->type, *addr);
     return false;
 }
 
+std::vector<Variable> Load::liveOut() {
+    return {*dest};
+}
+
+std::vector<std::string> Load::uses() const {
+    return {ptr};
+}
+
+std::vector<std::string> Load::defs() const {
+    return {dest->name};
+}
+
 std::ostream& Store::print(std::ostream& os) const {
     return os << "store " << this->ptr << " " << this->val << ";";
 }
 
+InstPtr Store::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<Store>(var(ptr), var(val));
+}
+
 ctrlStatus Store::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     int64_t* addr = reinterpret_cast<int64_t*>(vars[ptr].value);
-    if (heap.boundCheck(addr) == false)
-        throw std::runtime_error(std::format("Store: Uninitialized heap location and/or illegal offset: 0x{:x}", reinterpret_cast<uintptr_t>(addr)));
+    if (checked) CheckAccess(heap, addr, "Store");
     *addr = vars[val].value;
     return false;
 }
 
+std::vector<std::string> Store::uses() const {
+    return {ptr, val};
+}
+
 std::ostream& PtrAdd::print(std::ostream& os) const {
     return os << *this->dest << " = ptradd " << this->ptr << " " << this->offset << ";";
 }
 
+InstPtr PtrAdd::clone(const Renamer& var, [[maybe_unused]] const Renamer& label) const {
+    return std::make_shared<PtrAdd>(RenameVar(dest, var), var(ptr), var(offset));
+}
+
+bool PtrAdd::isPure() const {
+    return true;
+}
+
 ctrlStatus PtrAdd::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
     int64_t* addr = reinterpret_cast<int64_t*>(vars[ptr].value);
     vars[dest->name] = RuntimeVal(dest->type, reinterpret_cast<int64_t>(addr + vars[offset].value));
     return false;
 }
 
+std::vector<Variable> PtrAdd::liveOut() {
+    return {*dest};
+}
+
+std::vector<std::string> PtrAdd::uses() const {
+    return {ptr, offset};
+}
+
+std::vector<std::string> PtrAdd::defs() const {
+    return {dest->name};
+}
+
+std::ostream& Fused::print(std::ostream& os) const {
+    return os << *first << "\n  " << *second;
+}
+
+bool Fused::isTerminator() const {
+    return second->isTerminator();
+}
+
+std::vector<Variable> Fused::liveIn() {
+    auto vars = first->liveIn();
+    for (auto& var : second->liveIn()) vars.push_back(std::move(var));
+    return vars;
+}
+
+std::vector<Variable> Fused::liveOut() {
+    auto vars = first->liveOut();
+    for (auto& var : second->liveOut()) vars.push_back(std::move(var));
+    return vars;
+}
+
+std::vector<std::string> Fused::uses() const {
+    auto names = first->uses();
+    auto firstDefs = first->defs();
+    for (const auto& name : second->uses())
+        if (std::find(firstDefs.begin(), firstDefs.end(), name) == firstDefs.end()) names.push_back(name);
+    return names;
+}
+
+std::vector<std::string> Fused::defs() const {
+    auto names = first->defs(), rest = second->defs();
+    names.insert(names.end(), rest.begin(), rest.end());
+    return names;
+}
+
+InstPtr CompareBranch::clone(const Renamer& var, const Renamer& label) const {
+    return std::make_shared<CompareBranch>(std::static_pointer_cast<BinaryOp>(cmp->clone(var, label)),
+                                           std::static_pointer_cast<Branch>(branch->clone(var, label)), keep);
+}
+
+ctrlStatus CompareBranch::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
+    int64_t cond = EvalBinOp(cmp->op, vars[cmp->lhs->name].value, vars[cmp->rhs->name].value);
+    if (keep) vars[cmp->dest->name] = RuntimeVal(cmp->dest->type, cond);
+    return cond != 0;
+}
+
+InstPtr ConstBinaryOp::clone(const Renamer& var, const Renamer& label) const {
+    return std::make_shared<ConstBinaryOp>(std::static_pointer_cast<Constant>(c->clone(var, label)),
+                                           std::static_pointer_cast<BinaryOp>(op->clone(var, label)), keep);
+}
+
+ctrlStatus ConstBinaryOp::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
+    const std::string& name = c->dest->name;
+    if (keep) vars[name] = RuntimeVal(c->dest->type, c->val);
+    int64_t lhsVal = op->lhs->name == name ? c->val : vars[op->lhs->name].value;
+    int64_t rhsVal = op->rhs->name == name ? c->val : vars[op->rhs->name].value;
+    vars[op->dest->name] = RuntimeVal(op->dest->type, EvalBinOp(op->op, lhsVal, rhsVal));
+    return false;
+}
+
+InstPtr PtrAddLoad::clone(const Renamer& var, const Renamer& label) const {
+    return std::make_shared<PtrAddLoad>(std::static_pointer_cast<PtrAdd>(ptrAdd->clone(var, label)),
+                                        std::static_pointer_cast<Load>(load->clone(var, label)), keep);
+}
+
+ctrlStatus PtrAddLoad::execute(varContext& vars, [[maybe_unused]] HeapManager& heap) {
+    int64_t* addr = reinterpret_cast<int64_t*>(vars[ptrAdd->ptr].value) + vars[ptrAdd->offset].value;
+    if (keep) vars[ptrAdd->dest->name] = RuntimeVal(ptrAdd->dest->type, reinterpret_cast<int64_t>(addr));
+    if (load->checked) CheckAccess(heap, addr, "Load");
+    vars[load->dest->name] = RuntimeVal(load->dest->type, *addr);
+    return false;
+}
+
+std::string OpcodeName(const Instruction& instr) {
+    if (auto fused = dynamic_cast<const Fused*>(&instr)) return OpcodeName(*fused->first) + "+" + OpcodeName(*fused->second);
+    if (dynamic_cast<const Label*>(&instr)) return "label";
+    if (dynamic_cast<const Constant*>(&instr)) return "const";
+    if (auto bin = dynamic_cast<const BinaryOp*>(&instr)) return BinOpToStr(bin->op);
+    if (dynamic_cast<const UnaryOp*>(&instr)) return "not";
+    if (dynamic_cast<const Jump*>(&instr)) return "jmp";
+    if (dynamic_cast<const Branch*>(&instr)) return "br";
+    if (dynamic_cast<const Call*>(&instr)) return "call";
+    if (dynamic_cast<const Return*>(&instr)) return "ret";
+    if (dynamic_cast<const Print*>(&instr)) return "print";
+    if (dynamic_cast<const Id*>(&instr)) return "id";
+    if (dynamic_cast<const Alloc*>(&instr)) return "alloc";
+    if (dynamic_cast<const Free*>(&instr)) return "free";
+    if (dynamic_cast<const Load*>(&instr)) return "load";
+    if (dynamic_cast<const Store*>(&instr)) return "store";
+    if (dynamic_cast<const PtrAdd*>(&instr)) return "ptradd";
+    return "nop";
+}
+
 // return {BinaryOpType, operand type}
 std::pair<BinaryOpType, TypePtr> StrToBinOp(const std::string& op) {
     if (op == "add")
@@ -334,6 +575,35 @@ std::pair<BinaryOpType, TypePtr> StrToBinOp(const std::string& op) {
         return {BinaryOpType::BinInvalid, nullptr};
 }
 
+std::string BinOpToStr(BinaryOpType op) {
+    switch (op) {
+        case BinaryOpType::Add:
+            return "add";
+        case BinaryOpType::Sub:
+            return "sub";
+        case BinaryOpType::Mul:
+            return "mul";
+        case BinaryOpType::Div:
+            return "div";
+        case BinaryOpType::And:
+            return "and";
+        case BinaryOpType::Or:
+            return "or";
+        case BinaryOpType::Eq:
+            return "eq";
+        case BinaryOpType::Lt:
+            return "lt";
+        case BinaryOpType::Gt:
+            return "gt";
+        case BinaryOpType::Le:
+            return "le";
+        case BinaryOpType::Ge:
+            return "ge";
+        default:
+            throw std::runtime_error("Invalid BinaryOpType: " + std::to_string(static_cast<int>(op)));
+    }
+}
+
 // return {UnaryOpType, operand type}
 std::pair<UnaryOpType, TypePtr> StrToUnOp(const std::string& op) {
     if (op == "not")
@@ -342,6 +612,48 @@ std::pair<UnaryOpType, TypePtr> StrToUnOp(const std::string& op) {
         return {UnaryOpType::UnInvalid, nullptr};
 }
 
+int64_t EvalBinOp(BinaryOpType op, int64_t lhs, int64_t rhs) {
+    // unsigned arithmetic gives the two's complement wrap-around Bril expects
+    uint64_t l = static_cast<uint64_t>(lhs), r = static_cast<uint64_t>(rhs);
+    switch (op) {
+        case Add:
+            return static_cast<int64_t>(l + r);
+        case Sub:
+            return static_cast<int64_t>(l - r);
+        case Mul:
+            return static_cast<int64_t>(l * r);
+        case Div:
+            if (rhs == 0) throw std::runtime_error("error: division by zero");
+            if (rhs == -1) return static_cast<int64_t>(0 - l);  // INT64_MIN / -1 wraps
+            return lhs / rhs;
+        case And:
+            return lhs & rhs;
+        case Or:
+            return lhs | rhs;
+        case Eq:
+            return lhs == rhs;
+        case Lt:
+            return lhs < rhs;
+        case Gt:
+            return lhs > rhs;
+        case Le:
+            return lhs <= rhs;
+        case Ge:
+            return lhs >= rhs;
+        default:
+            throw std::runtime_error("Invalid binary operator");
+    }
+}
+
+int64_t EvalUnOp(UnaryOpType op, int64_t src) {
+    switch (op) {
+        case Not:
+            return !src;
+        default:
+            throw std::runtime_error("Invalid unary operator");
+    }
+}
+
 InstPtr ParseInstr(const json& instJson) {
     if (instJson.contains("label")) {
         std::string label = instJson["label"];
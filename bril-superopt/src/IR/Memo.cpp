@@ -0,0 +1,52 @@
+#include <IR/Function.h>
+#include <IR/Memo.h>
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <functional>
+#include <ostream>
+
+namespace ir {
+
+MemoTable::MemoTable(size_t slots) : slots(std::bit_ceil(std::max<size_t>(slots, 1))) {}
+
+MemoTable::Key MemoTable::makeKey(const Function& func, const varContext& vars) {
+    Key key;
+    key.reserve(func.args.size());
+    for (const auto& arg : func.args) key.push_back(vars.at(arg->name).value);
+    return key;
+}
+
+MemoTable::Slot& MemoTable::slotFor(const Function& func, const Key& key) {
+    size_t seed = std::hash<const Function*>{}(&func);
+    for (int64_t val : key) seed ^= std::hash<int64_t>{}(val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return slots[seed & (slots.size() - 1)];
+}
+
+const std::optional<int64_t>* MemoTable::lookup(const Function& func, const Key& key) {
+    Slot& slot = slotFor(func, key);
+    Stats& stat = stats[&func];
+    if (slot.func == &func && slot.key == key) {
+        stat.hits++;
+        return &slot.ret;
+    }
+    stat.misses++;
+    return nullptr;
+}
+
+void MemoTable::insert(const Function& func, Key key, std::optional<int64_t> ret) {
+    Slot& slot = slotFor(func, key);
+    slot.func = &func;
+    slot.key = std::move(key);
+    slot.ret = ret;
+}
+
+void MemoTable::report(std::ostream& os) const {
+    std::vector<std::pair<const Function*, Stats>> sorted(stats.begin(), stats.end());
+    std::ranges::sort(sorted, [](const auto& lhs, const auto& rhs) { return lhs.first->name < rhs.first->name; });
+    for (const auto& [func, stat] : sorted)
+        os << std::format("memo: @{} hits={} misses={}\n", func->name, stat.hits, stat.misses);
+}
+
+}  // namespace ir
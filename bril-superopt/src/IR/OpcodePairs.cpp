@@ -0,0 +1,56 @@
+#include <IR/BasicBlock.h>
+#include <IR/Instruction.h>
+#include <IR/OpcodePairs.h>
+
+#include <algorithm>
+#include <format>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ir {
+
+namespace {
+
+// opcodes in execution order; labels do nothing and are left out
+std::vector<std::string> Opcodes(const BasicBlock& bb) {
+    std::vector<std::string> ops;
+    for (const auto& instr : bb.instrs)
+        if (!dynamic_cast<const Label*>(instr.get())) ops.push_back(OpcodeName(*instr));
+    return ops;
+}
+
+}  // namespace
+
+void OpcodePairs::report(std::ostream& os, size_t top) const {
+    std::map<std::pair<std::string, std::string>, uint64_t> pairs;
+    uint64_t total = 0;
+    for (const auto& [bb, preds] : entries) {
+        auto ops = Opcodes(*bb);
+        if (ops.empty()) continue;
+        uint64_t runs = 0;
+        for (const auto& [prev, count] : preds) {
+            runs += count;
+            if (!prev) continue;
+            auto prevOps = Opcodes(*prev);
+            if (prevOps.empty()) continue;
+            pairs[{prevOps.back(), ops.front()}] += count;
+            total += count;
+        }
+        for (size_t i = 0; i + 1 < ops.size(); i++) {
+            pairs[{ops[i], ops[i + 1]}] += runs;
+            total += runs;
+        }
+    }
+    std::vector<std::pair<std::pair<std::string, std::string>, uint64_t>> sorted(pairs.begin(), pairs.end());
+    std::ranges::stable_sort(sorted, [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+    os << std::format("pairs: total={}\n", total);
+    for (size_t i = 0; i < std::min(top, sorted.size()); i++) {
+        const auto& [pair, count] = sorted[i];
+        os << std::format("pair: {} {} count={} ({:.1f}%)\n", pair.first, pair.second, count, 100.0 * count / total);
+    }
+}
+
+}  // namespace ir
@@ -8,9 +8,11 @@ using json = nlohmann::json;
 
 namespace ir {
 
-ProgramPtr parse(std::istream& input) {
+ProgramPtr parse(std::istream& input, Stats* stats) {
+    if (stats) stats->phase("parse");
     json progJson = json::parse(input);
     // std::cout << progJson.dump(4) << std::endl;
+    if (stats) stats->phase("construction");
     auto program = std::make_shared<Program>(progJson);
     return program;
 }
@@ -0,0 +1,124 @@
+#include <IR/PerfCounters.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace ir {
+
+#ifdef __linux__
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+const Event Events[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"LLC-load-misses", PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {"task-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+};
+
+// 'group' is the leader's fd, -1 to open the leader itself
+int Open(const Event& event, int group) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = group < 0;  // the members follow the leader
+    // what unprivileged users may count with the default perf_event_paranoid
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+    for (const auto& event : Events) {
+        int fd = Open(event, leader);
+        // EACCES and EPERM affect every event: perf_event_paranoid forbids it
+        if (fd < 0 && (errno == EACCES || errno == EPERM || errno == ENOSYS)) {
+            auto reason = std::string(std::strerror(errno));
+            for (auto& counter : counters)
+                if (counter.fd >= 0) close(counter.fd);
+            throw std::runtime_error("error: perf_event_open: " + reason);
+        }
+        if (leader < 0) leader = fd;
+        counters.push_back(Counter{event.name, fd});
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (auto& counter : counters)
+        if (counter.fd >= 0) close(counter.fd);
+}
+
+void PerfCounters::start() {
+    if (leader < 0) return;
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounters::stop() {
+    if (leader >= 0) ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+std::vector<std::pair<std::string, std::optional<uint64_t>>> PerfCounters::read() const {
+    // nr, time enabled, time running, then one value per member in the
+    // order they joined the group, the leader first
+    std::vector<uint64_t> group(3 + counters.size());
+    ssize_t size = leader < 0 ? -1 : ::read(leader, group.data(), group.size() * sizeof(uint64_t));
+    bool valid = size >= static_cast<ssize_t>(3 * sizeof(uint64_t)) && group[2] > 0;
+    uint64_t enabled = valid ? group[1] : 0, running = valid ? group[2] : 0;
+    std::vector<std::pair<std::string, std::optional<uint64_t>>> values;
+    size_t member = 0;
+    for (const auto& counter : counters) {
+        if (counter.fd < 0 || !valid || member >= group[0]) {
+            values.emplace_back(counter.name, std::nullopt);
+            continue;
+        }
+        // scaled up when the group only ran for part of the time, as perf stat does
+        auto value = static_cast<uint64_t>(static_cast<long double>(group[3 + member++]) * enabled / running);
+        values.emplace_back(counter.name, value);
+    }
+    return values;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    throw std::runtime_error("error: perf counters are only supported on Linux");
+}
+
+PerfCounters::~PerfCounters() = default;
+void PerfCounters::start() {}
+void PerfCounters::stop() {}
+
+std::vector<std::pair<std::string, std::optional<uint64_t>>> PerfCounters::read() const {
+    return {};
+}
+
+#endif
+
+void PerfCounters::report(std::ostream& os) const {
+    for (const auto& [name, value] : read())
+        os << std::format("{}: {}\n", name, value ? std::to_string(*value) : std::string("<not supported>"));
+}
+
+}  // namespace ir
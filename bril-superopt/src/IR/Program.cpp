@@ -93,9 +93,11 @@ std::ostream& operator<<(std::ostream& os, const Program& prog) {
     return os;
 }
 
-void Program::execute(varContext& vars, HeapManager& heap) {
+std::optional<int64_t> Program::execute(varContext& vars, HeapManager& heap) {
+    // passes may have moved calls around since construction
+    for (auto& func : this->functions) func->MarkTailCalls();
     if (this->mainFunc)
-        this->mainFunc->execute(vars, heap);
+        return this->mainFunc->execute(vars, heap);
     else
         throw std::runtime_error("error: main function not found");
 }
@@ -0,0 +1,127 @@
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+#include <IR/Sampler.h>
+
+#ifdef __linux__
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ir {
+
+// the signal handler may only touch lock-free atomics
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<const Instruction*>::is_always_lock_free);
+
+#ifdef __linux__
+
+Sampler::Sampler(unsigned hz) {
+    if (hz == 0 || hz > 1000000) throw std::runtime_error("error: the sampling rate must be between 1 and 1000000 Hz");
+    Sampler* none = nullptr;
+    if (!active.compare_exchange_strong(none, this)) throw std::runtime_error("error: only one sampler can run at a time");
+    // the constructor is not finished, so the destructor will not release it
+    auto fail = [&](const char* call) {
+        auto reason = std::string(std::strerror(errno));
+        itimerval off{};
+        setitimer(ITIMER_PROF, &off, nullptr);
+        active = nullptr;
+        throw std::runtime_error(std::format("error: {}: {}", call, reason));
+    };
+    struct sigaction action {};
+    action.sa_handler = handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &action, nullptr) != 0) fail("sigaction");
+    unsigned period = 1000000 / hz;  // us; tv_usec must stay below a second
+    itimerval timer{};
+    timer.it_interval.tv_sec = period / 1000000;
+    timer.it_interval.tv_usec = period % 1000000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) fail("setitimer");
+}
+
+void Sampler::stop() {
+    if (stopped) return;
+    stopped = true;
+    itimerval off{};
+    setitimer(ITIMER_PROF, &off, nullptr);
+    signal(SIGPROF, SIG_IGN);  // a signal still pending must not terminate the process
+    drain();
+    active = nullptr;
+}
+
+#else
+
+Sampler::Sampler([[maybe_unused]] unsigned hz) {
+    throw std::runtime_error("error: sampling is only supported on Linux");
+}
+
+void Sampler::stop() {}
+
+#endif
+
+Sampler::~Sampler() { stop(); }
+
+void Sampler::handler(int) {
+    Sampler* sampler = active.load(std::memory_order_acquire);
+    if (!sampler) return;
+    Ring& ring = sampler->ring;
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) == RingSize) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring.slots[head % RingSize] = sampler->current.load(std::memory_order_relaxed);
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Sampler::drain() {
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    for (; tail != head; tail++) counts[ring.slots[tail % RingSize]]++;
+    ring.tail.store(tail, std::memory_order_release);
+}
+
+void Sampler::report(const Program& prog, std::ostream& os) const {
+    uint64_t total = 0;
+    for (const auto& [instr, count] : counts) total += count;
+    auto share = [&](uint64_t count) { return total ? 100.0 * count / total : 0.0; };
+    os << std::format("samples: {} ({} dropped)\n", total, ring.dropped.load());
+
+    struct Site {
+        std::string where;
+        const Instruction* instr;
+        uint64_t count;
+        std::optional<uint64_t> runs;
+    };
+    std::vector<Site> sites;
+    uint64_t located = 0;
+    for (const auto& func : prog.functions)
+        for (const auto& bb : func->basicBlocks)
+            for (size_t i = 0; i < bb->instrs.size(); i++) {
+                auto found = counts.find(bb->instrs[i].get());
+                if (found == counts.end()) continue;
+                sites.push_back({std::format("@{}{}[{}]", func->name, func->blockName(*bb), i), found->first, found->second,
+                                 func->counting ? std::optional(bb->runs) : std::nullopt});
+                located += found->second;
+            }
+    std::ranges::stable_sort(sites, [](const Site& lhs, const Site& rhs) { return lhs.count > rhs.count; });
+    for (const auto& site : sites) {
+        os << std::format("sample: {} count={} ({:.1f}%)", site.where, site.count, share(site.count));
+        if (site.runs) os << std::format(" block_runs={}", *site.runs);
+        os << "  " << *site.instr << "\n";
+    }
+    // before and after the interpreter, in compiled code, or in instructions no longer in 'prog'
+    if (total > located) os << std::format("sample: <outside the interpreter> count={} ({:.1f}%)\n", total - located, share(total - located));
+}
+
+}  // namespace ir
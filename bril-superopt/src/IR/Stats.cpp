@@ -0,0 +1,76 @@
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Stats.h>
+#include <IR/Type.h>
+
+#include <format>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+namespace ir {
+
+Allocations allocations;
+
+void Stats::phase(std::string name) {
+    end();
+    running = Start{std::move(name), std::chrono::steady_clock::now(), std::clock(), allocations};
+}
+
+void Stats::end() {
+    if (!running) return;
+    auto wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - running->wall).count();
+    auto cpu = 1000.0 * static_cast<double>(std::clock() - running->cpu) / CLOCKS_PER_SEC;
+    phases.push_back({std::move(running->name), wall, cpu, allocations.bytes - running->allocated.bytes,
+                      allocations.count - running->allocated.count});
+    running.reset();
+}
+
+void Stats::count(const Program& prog) {
+    // the walk's own allocations are not the program's
+    bool counting = std::exchange(allocations.counting, false);
+    functions = prog.functions.size();
+    blocks = instructions = variables = 0;
+    // Type objects are not shared between variables, so this is about how
+    // many the IR keeps alive, not how many kinds of values it has
+    std::unordered_set<const Type*> held;
+    auto hold = [&](const TypePtr& type) {
+        for (auto t = type; t && held.insert(t.get()).second;) {
+            auto ptr = std::dynamic_pointer_cast<PointerType>(t);
+            t = ptr ? ptr->getPointee() : nullptr;
+        }
+    };
+    for (const auto& func : prog.functions) {
+        blocks += func->basicBlocks.size();
+        std::unordered_set<std::string> names;
+        for (const auto& arg : func->args) {
+            names.insert(arg->name);
+            hold(arg->type);
+        }
+        hold(func->getRetType());
+        for (const auto& bb : func->basicBlocks) {
+            instructions += bb->instrs.size();
+            for (const auto& instr : bb->instrs) {
+                for (const auto& name : instr->uses()) names.insert(name);
+                for (const auto& name : instr->defs()) names.insert(name);
+                for (const auto& var : instr->liveIn()) hold(var.type);
+                for (const auto& var : instr->liveOut()) hold(var.type);
+            }
+        }
+        variables += names.size();
+    }
+    types = held.size();
+    allocations.counting = counting;
+}
+
+void Stats::report(std::ostream& os, const HeapManager& heap) const {
+    for (const auto& phase : phases)
+        os << std::format("{}: {:.3f} ms wall, {:.3f} ms cpu, {} bytes in {} allocations\n", phase.name, phase.wallMs, phase.cpuMs, phase.bytes,
+                          phase.allocations);
+    os << std::format("ir nodes: {} functions, {} blocks, {} instructions, {} variables (distinct per function), {} type objects\n", functions,
+                      blocks, instructions, variables, types);
+    os << std::format("heap peak: {} bytes\n", heap.peak() * sizeof(int64_t));
+}
+
+}  // namespace ir
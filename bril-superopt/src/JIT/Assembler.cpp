@@ -0,0 +1,198 @@
+#include <JIT/Assembler.h>
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace jit {
+
+Assembler::Label Assembler::newLabel() {
+    labels.emplace_back();
+    return labels.size() - 1;
+}
+
+void Assembler::bind(Label label) {
+    assert(labels[label].pos == SIZE_MAX && "label bound twice");
+    labels[label].pos = code.size();
+}
+
+void Assembler::finalize() {
+    for (const auto& label : labels) {
+        for (size_t fixup : label.fixups) {
+            if (label.pos == SIZE_MAX) throw std::runtime_error("jit: jump to an unbound label");
+            int32_t rel = static_cast<int32_t>(label.pos - (fixup + 4));
+            std::memcpy(&code[fixup], &rel, sizeof(rel));
+        }
+    }
+}
+
+void Assembler::imm32(int32_t imm) {
+    for (int i = 0; i < 4; i++) byte(static_cast<uint8_t>(imm >> (8 * i)));
+}
+
+void Assembler::rex(bool w, uint8_t reg, uint8_t index, uint8_t base) {
+    uint8_t prefix = 0x40 | (w ? 8 : 0) | ((reg & 8) >> 1) | ((index & 8) >> 2) | ((base & 8) >> 3);
+    if (prefix != 0x40) byte(prefix);
+}
+
+void Assembler::modrmReg(uint8_t reg, uint8_t rm) {
+    byte(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+// always [base + disp32], rsp/r12 as base need a SIB byte
+void Assembler::modrmMem(uint8_t reg, Reg base, int32_t disp) {
+    byte(0x80 | ((reg & 7) << 3) | (base & 7));
+    if ((base & 7) == RSP) byte(0x24);
+    imm32(disp);
+}
+
+void Assembler::rel32(Label label) {
+    labels[label].fixups.push_back(code.size());
+    imm32(0);
+}
+
+void Assembler::movImm(Reg dst, int64_t imm) {
+    rex(true, 0, 0, dst);
+    byte(0xB8 + (dst & 7));
+    for (int i = 0; i < 8; i++) byte(static_cast<uint8_t>(static_cast<uint64_t>(imm) >> (8 * i)));
+}
+
+void Assembler::mov(Reg dst, Reg src) {
+    rex(true, src, 0, dst);
+    byte(0x89);
+    modrmReg(src, dst);
+}
+
+void Assembler::load(Reg dst, Reg base, int32_t disp) {
+    rex(true, dst, 0, base);
+    byte(0x8B);
+    modrmMem(dst, base, disp);
+}
+
+void Assembler::store(Reg base, int32_t disp, Reg src) {
+    rex(true, src, 0, base);
+    byte(0x89);
+    modrmMem(src, base, disp);
+}
+
+void Assembler::lea(Reg dst, Reg base, int32_t disp) {
+    rex(true, dst, 0, base);
+    byte(0x8D);
+    modrmMem(dst, base, disp);
+}
+
+void Assembler::leaScaled(Reg dst, Reg base, Reg index) {
+    assert((base & 7) != RBP && index != RSP && "unsupported addressing");
+    rex(true, dst, index, base);
+    byte(0x8D);
+    byte(0x04 | ((dst & 7) << 3));                   // mod 00, rm = SIB
+    byte(0xC0 | ((index & 7) << 3) | (base & 7));  // scale 8
+}
+
+void Assembler::alu(AluOp op, Reg dst, Reg base, int32_t disp) {
+    rex(true, dst, 0, base);
+    byte(op);
+    modrmMem(dst, base, disp);
+}
+
+void Assembler::imul(Reg dst, Reg base, int32_t disp) {
+    rex(true, dst, 0, base);
+    byte(0x0F);
+    byte(0xAF);
+    modrmMem(dst, base, disp);
+}
+
+void Assembler::test(Reg lhs, Reg rhs) {
+    rex(true, rhs, 0, lhs);
+    byte(0x85);
+    modrmReg(rhs, lhs);
+}
+
+void Assembler::cmpImm(Reg lhs, int32_t imm) {
+    rex(true, 0, 0, lhs);
+    byte(0x81);
+    modrmReg(7, lhs);
+    imm32(imm);
+}
+
+void Assembler::subImm(Reg dst, int32_t imm) {
+    rex(true, 0, 0, dst);
+    byte(0x81);
+    modrmReg(5, dst);
+    imm32(imm);
+}
+
+void Assembler::xor32(Reg dst, Reg src) {
+    rex(false, src, 0, dst);
+    byte(0x31);
+    modrmReg(src, dst);
+}
+
+void Assembler::setcc(Cond cond, Reg dst) {
+    // setcc on the low byte, then movzx to clear the rest
+    byte(0x40 | ((dst & 8) >> 3));  // REX so that sil/dil are addressable
+    byte(0x0F);
+    byte(0x90 | cond);
+    modrmReg(0, dst);
+    rex(true, dst, 0, dst);
+    byte(0x0F);
+    byte(0xB6);
+    modrmReg(dst, dst);
+}
+
+void Assembler::push(Reg reg) {
+    rex(false, 0, 0, reg);
+    byte(0x50 + (reg & 7));
+}
+
+void Assembler::pop(Reg reg) {
+    rex(false, 0, 0, reg);
+    byte(0x58 + (reg & 7));
+}
+
+void Assembler::call(Reg target) {
+    rex(false, 0, 0, target);
+    byte(0xFF);
+    modrmReg(2, target);
+}
+
+void Assembler::callMem(Reg base, int32_t disp) {
+    rex(false, 0, 0, base);
+    byte(0xFF);
+    modrmMem(2, base, disp);
+}
+
+void Assembler::jmp(Label label) {
+    byte(0xE9);
+    rel32(label);
+}
+
+void Assembler::jmpReg(Reg target) {
+    rex(false, 0, 0, target);
+    byte(0xFF);
+    modrmReg(4, target);
+}
+
+void Assembler::jmpMem(Reg base, int32_t disp) {
+    rex(false, 0, 0, base);
+    byte(0xFF);
+    modrmMem(4, base, disp);
+}
+
+void Assembler::jcc(Cond cond, Label label) {
+    byte(0x0F);
+    byte(0x80 | cond);
+    rel32(label);
+}
+
+void Assembler::repStosq() {
+    byte(0xF3);
+    byte(0x48);
+    byte(0xAB);
+}
+
+void Assembler::ret() {
+    byte(0xC3);
+}
+
+}  // namespace jit
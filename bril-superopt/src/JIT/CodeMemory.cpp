@@ -0,0 +1,75 @@
+#include <JIT/CodeMemory.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+// provided by the unwinder (libgcc_s)
+extern "C" void __register_frame(void* begin);
+extern "C" void __deregister_frame(void* begin);
+
+namespace jit {
+
+static void Append32(std::vector<uint8_t>& buf, uint32_t val) {
+    for (int i = 0; i < 4; i++) buf.push_back(static_cast<uint8_t>(val >> (8 * i)));
+}
+
+static void Append64(std::vector<uint8_t>& buf, uint64_t val) {
+    for (int i = 0; i < 8; i++) buf.push_back(static_cast<uint8_t>(val >> (8 * i)));
+}
+
+// pad with DW_CFA_nop and fill in the length field of the entry at 'start'
+static void CloseEntry(std::vector<uint8_t>& buf, size_t start) {
+    while ((buf.size() - start) % 8) buf.push_back(0);
+    uint32_t len = static_cast<uint32_t>(buf.size() - start - 4);
+    std::memcpy(&buf[start], &len, sizeof(len));
+}
+
+static std::vector<uint8_t> BuildEhFrame(const uint8_t* code, size_t size, const std::vector<uint8_t>& cfi) {
+    std::vector<uint8_t> buf;
+    // CIE: augmentation "zR" with absolute pointers, code align 1, data align -8, RA in r16
+    Append32(buf, 0);
+    Append32(buf, 0);  // CIE id
+    const uint8_t cie[] = {1, 'z', 'R', 0, 1, 0x78, 16, 1, 0x00,
+                           0x0c, 7, 8, 0x90, 1};  // CFA = rsp + 8, RA at CFA - 8
+    buf.insert(buf.end(), std::begin(cie), std::end(cie));
+    CloseEntry(buf, 0);
+    // FDE covering the whole code block
+    size_t fde = buf.size();
+    Append32(buf, 0);
+    Append32(buf, static_cast<uint32_t>(buf.size()));  // back to the CIE
+    Append64(buf, reinterpret_cast<uint64_t>(code));
+    Append64(buf, size);
+    buf.push_back(0);  // no augmentation data
+    buf.insert(buf.end(), cfi.begin(), cfi.end());
+    CloseEntry(buf, fde);
+    Append32(buf, 0);  // terminator
+    return buf;
+}
+
+ExecutableCode::ExecutableCode(const std::vector<uint8_t>& code, const std::vector<uint8_t>& cfi) : codeSize(code.size()) {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    mapSize = (code.size() + page - 1) / page * page;
+    void* ptr = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) throw std::runtime_error("error: jit: cannot map code memory");
+    mem = static_cast<uint8_t*>(ptr);
+    std::memcpy(mem, code.data(), code.size());
+    if (mprotect(mem, mapSize, PROT_READ | PROT_EXEC) != 0) {
+        munmap(mem, mapSize);
+        throw std::runtime_error("error: jit: cannot make code memory executable");
+    }
+    if (!cfi.empty()) {
+        ehFrame = BuildEhFrame(mem, codeSize, cfi);
+        __register_frame(ehFrame.data());
+    }
+}
+
+ExecutableCode::~ExecutableCode() {
+    if (!ehFrame.empty()) __deregister_frame(ehFrame.data());
+    munmap(mem, mapSize);
+}
+
+}  // namespace jit
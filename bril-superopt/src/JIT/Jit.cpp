@@ -0,0 +1,485 @@
+#include <Analysis/Liveness.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Heap.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+#include <IR/Type.h>
+#include <JIT/Assembler.h>
+#include <JIT/CodeMemory.h>
+#include <JIT/Jit.h>
+#include <JIT/PerfMap.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace jit {
+
+namespace {
+
+// runtime helpers called from compiled code
+
+int64_t JitDiv(int64_t lhs, int64_t rhs) {
+    return ir::EvalBinOp(ir::Div, lhs, rhs);
+}
+
+int64_t JitAlloc(JitContext* ctx, int64_t size) {
+    return reinterpret_cast<int64_t>(ctx->heap->allocate(size));
+}
+
+void JitFree(JitContext* ctx, int64_t ptr) {
+    ctx->heap->deallocate(reinterpret_cast<int64_t*>(ptr));
+}
+
+int64_t JitLoad(JitContext* ctx, int64_t ptr) {
+    int64_t* addr = reinterpret_cast<int64_t*>(ptr);
+    if (ctx->heap->boundCheck(addr) == false)
+        throw std::runtime_error(std::format("Load: Uninitialized heap location and/or illegal offset: 0x{:x}", reinterpret_cast<uintptr_t>(addr)));
+    return *addr;
+}
+
+void JitStore(JitContext* ctx, int64_t ptr, int64_t val) {
+    int64_t* addr = reinterpret_cast<int64_t*>(ptr);
+    if (ctx->heap->boundCheck(addr) == false)
+        throw std::runtime_error(std::format("Store: Uninitialized heap location and/or illegal offset: 0x{:x}", reinterpret_cast<uintptr_t>(addr)));
+    *addr = val;
+}
+
+void JitPrint(const uint8_t* frame, const PrintSite* site) {
+    std::ostream& os = ir::Output();
+    for (const auto& [offset, type] : site->args)
+        os << ir::RuntimeVal(type, *reinterpret_cast<const int64_t*>(frame + offset)).toString() << ' ';
+    os << std::endl;
+}
+
+// entry of functions that are not compiled: run them in the interpreter
+int64_t InterpretEntry(const int64_t* args, JitContext* ctx, JitFunction* self) {
+    ir::varContext vars;
+    for (size_t i = 0; i < self->func->args.size(); i++)
+        vars[self->func->args[i]->name] = ir::RuntimeVal(self->func->args[i]->type, args[i]);
+    return self->func->execute(vars, *ctx->heap).value_or(0);
+}
+
+// DWARF CFI of the prologue emitted by FunctionCompiler:
+// push rbp; mov rbp, rsp; push rbx; push r12
+const std::vector<uint8_t> PrologueCFI = {
+    0x41, 0x0e, 0x10, 0x86, 0x02,  // +1: CFA = rsp + 16, rbp at CFA - 16
+    0x43, 0x0d, 0x06,              // +3: CFA = rbp + 16
+    0x41, 0x83, 0x03,              // +1: rbx at CFA - 24
+    0x42, 0x8c, 0x04,              // +2: r12 at CFA - 32
+};
+
+// Frame layout, rbp-relative: saved rbx at -8, saved r12 at -16, variable
+// slot k at -24 - 8k. Outgoing call arguments live at [rsp].
+class FunctionCompiler {
+   public:
+    FunctionCompiler(ir::Function& func, JitEngine& engine, std::vector<std::unique_ptr<PrintSite>>& printSites) : func(func), engine(engine), printSites(printSites) {}
+
+    // false if the function uses something the JIT cannot handle
+    bool compile() {
+        if (readsUndefined() || !assignSlots()) return false;
+        prologue();
+        for (size_t i = 0; i < func.basicBlocks.size(); i++) blockLabels[func.basicBlocks[i].get()] = as.newLabel();
+        if (func.basicBlocks.empty() || func.getEntry() != func.basicBlocks.front()) {
+            if (!func.getEntry()) {
+                as.xor32(RAX, RAX);
+                epilogue();
+            } else
+                as.jmp(blockLabels.at(func.getEntry().get()));
+        }
+        for (size_t i = 0; i < func.basicBlocks.size(); i++) {
+            const auto& bb = func.basicBlocks[i];
+            ir::BasicBlock* next = i + 1 < func.basicBlocks.size() ? func.basicBlocks[i + 1].get() : nullptr;
+            as.bind(blockLabels.at(bb.get()));
+            for (const auto& instr : bb->instrs) {
+                if (!emit(*instr, *bb, next)) return false;
+                if (instr->isTerminator()) break;
+            }
+            if (bb->instrs.empty() || !bb->instrs.back()->isTerminator()) fallThrough(bb->notTaken.lock().get(), next);
+        }
+        osrEntry();
+        as.finalize();
+        return true;
+    }
+
+    const std::vector<uint8_t>& code() const { return as.code; }
+
+    // the code as perf should name it: the prologue under the function's
+    // name, then every block and the OSR entry
+    std::vector<std::pair<size_t, std::string>> regions() const {
+        std::string prefix = "bril:@" + func.name;
+        std::vector<std::pair<size_t, std::string>> named = {{0, prefix}};
+        for (const auto& bb : func.basicBlocks) named.emplace_back(as.offset(blockLabels.at(bb.get())), prefix + func.blockName(*bb));
+        if (auto offset = osrOffset()) named.emplace_back(*offset, prefix + ".osr");
+        return named;
+    }
+
+    // where the OSR entry starts, if the function has marked loop headers
+    std::optional<size_t> osrOffset() const {
+        if (osr.headers.empty()) return std::nullopt;
+        return as.offset(osrLabel);
+    }
+
+    OsrInfo takeOsrInfo() {
+        for (const auto& [name, offset] : slots) osr.slotIndex[name] = static_cast<size_t>((-24 - offset) / 8);
+        osr.numSlots = slots.size();
+        return std::move(osr);
+    }
+
+   private:
+    ir::Function& func;
+    JitEngine& engine;
+    std::vector<std::unique_ptr<PrintSite>>& printSites;
+    Assembler as;
+    std::unordered_map<std::string, int32_t> slots;
+    std::unordered_map<std::string, ir::TypePtr> types;  // nullptr when ambiguous
+    std::unordered_map<const ir::BasicBlock*, Assembler::Label> blockLabels;
+    Assembler::Label argsLabel = 0, osrLabel = 0;
+    OsrInfo osr;
+    size_t maxCallArgs = 0;
+
+    int32_t slot(const std::string& name) const { return slots.at(name); }
+
+    void recordType(const ir::Variable& var) {
+        auto [it, inserted] = types.emplace(var.name, var.type);
+        if (!inserted && it->second && !(*it->second == *var.type)) it->second = nullptr;
+    }
+
+    // whether some path reads a variable before assigning it: the interpreter
+    // fails there, a zeroed slot would not
+    bool readsUndefined() const {
+        if (!func.getEntry()) return false;
+        opt::Liveness liveness(func);
+        for (const auto& name : liveness.liveIn(func.getEntry().get()))
+            if (std::ranges::none_of(func.args, [&](const auto& arg) { return arg->name == name; })) return true;
+        return false;
+    }
+
+    bool assignSlots() {
+        auto addSlot = [this](const std::string& name) {
+            if (!slots.contains(name)) slots[name] = -24 - 8 * static_cast<int32_t>(slots.size());
+        };
+        for (const auto& arg : func.args) {
+            addSlot(arg->name);
+            recordType(*arg);
+        }
+        for (const auto& bb : func.basicBlocks) {
+            for (const auto& instr : bb->instrs) {
+                for (const auto& name : instr->uses()) addSlot(name);
+                for (const auto& name : instr->defs()) addSlot(name);
+                for (const auto& var : instr->liveOut()) recordType(var);
+                if (auto call = std::dynamic_pointer_cast<ir::Call>(instr)) {
+                    if (call->func.expired() || call->args.size() != call->func.lock()->args.size()) return false;
+                    maxCallArgs = std::max(maxCallArgs, call->args.size());
+                }
+            }
+        }
+        return true;
+    }
+
+    // push rbp; mov rbp, rsp; push rbx; push r12 (see PrologueCFI), then
+    // reserve and zero the frame; rbx = ctx, r12 = incoming values
+    void frameSetup() {
+        as.push(RBP);
+        as.mov(RBP, RSP);
+        as.push(RBX);
+        as.push(R12);
+        int32_t frame = static_cast<int32_t>((slots.size() + maxCallArgs) * 8);
+        frame = (frame + 15) / 16 * 16;
+        if (frame) as.subImm(RSP, frame);
+        as.mov(RBX, RSI);
+        as.mov(R12, RDI);
+        if (frame) {  // zeroed, though no slot is read unassigned (see readsUndefined)
+            as.lea(RDI, RSP, 0);
+            as.movImm(RCX, frame / 8);
+            as.xor32(RAX, RAX);
+            as.repStosq();
+        }
+    }
+
+    void prologue() {
+        frameSetup();
+        argsLabel = as.newLabel();
+        as.bind(argsLabel);
+        for (size_t i = 0; i < func.args.size(); i++) {
+            as.load(RAX, R12, static_cast<int32_t>(8 * i));
+            as.store(RBP, slot(func.args[i]->name), RAX);
+        }
+    }
+
+    // On-stack replacement entry (OsrFn): rdi holds every variable in slot
+    // order and rcx the index of the loop header to resume at.
+    void osrEntry() {
+        std::vector<ir::BasicBlock*> headers;
+        for (const auto& bb : func.basicBlocks)
+            if (bb->loopHeader) headers.push_back(bb.get());
+        if (headers.empty()) return;
+        osrLabel = as.newLabel();
+        as.bind(osrLabel);
+        as.mov(RDX, RCX);  // rep stosq clobbers rcx
+        frameSetup();
+        for (const auto& [name, offset] : slots) {
+            as.load(RAX, R12, -24 - offset);
+            as.store(RBP, offset, RAX);
+        }
+        for (size_t i = 0; i < headers.size(); i++) {
+            osr.headers[headers[i]] = static_cast<int64_t>(i);
+            if (i + 1 < headers.size()) {
+                as.cmpImm(RDX, static_cast<int32_t>(i));
+                as.jcc(CondE, blockLabels.at(headers[i]));
+            } else
+                as.jmp(blockLabels.at(headers[i]));
+        }
+    }
+
+    void epilogue() {
+        as.lea(RSP, RBP, -16);
+        as.pop(R12);
+        as.pop(RBX);
+        as.pop(RBP);
+        as.ret();
+    }
+
+    void callHelper(const void* helper) {
+        as.movImm(RAX, reinterpret_cast<int64_t>(helper));
+        as.call(RAX);
+    }
+
+    void fallThrough(ir::BasicBlock* succ, ir::BasicBlock* next) {
+        if (!succ) {  // falling off the end returns nothing
+            as.xor32(RAX, RAX);
+            epilogue();
+        } else if (succ != next)
+            as.jmp(blockLabels.at(succ));
+    }
+
+    void emitCall(const ir::Call& call) {
+        JitFunction* callee = &engine.record(*call.func.lock());
+        if (call.tail) {
+            // arguments go through the context buffer since this frame is about to go away
+            as.load(RCX, RBX, offsetof(JitContext, tailArgs));
+            for (size_t i = 0; i < call.args.size(); i++) {
+                as.load(RAX, RBP, slot(call.args[i]));
+                as.store(RCX, static_cast<int32_t>(8 * i), RAX);
+            }
+            if (callee->func == &func) {  // self tail call: loop back to argument binding
+                as.mov(R12, RCX);
+                as.jmp(argsLabel);
+                return;
+            }
+            as.mov(RDI, RCX);
+            as.mov(RSI, RBX);
+            as.movImm(RDX, reinterpret_cast<int64_t>(callee));
+            as.lea(RSP, RBP, -16);
+            as.pop(R12);
+            as.pop(RBX);
+            as.pop(RBP);
+            as.jmpMem(RDX, offsetof(JitFunction, entry));
+            return;
+        }
+        for (size_t i = 0; i < call.args.size(); i++) {
+            as.load(RAX, RBP, slot(call.args[i]));
+            as.store(RSP, static_cast<int32_t>(8 * i), RAX);
+        }
+        as.lea(RDI, RSP, 0);
+        as.mov(RSI, RBX);
+        as.movImm(RDX, reinterpret_cast<int64_t>(callee));
+        as.callMem(RDX, offsetof(JitFunction, entry));
+        if (call.dest) as.store(RBP, slot(call.dest->name), RAX);
+    }
+
+    bool emitPrint(const ir::Print& print) {
+        auto site = std::make_unique<PrintSite>();
+        for (const auto& arg : print.args) {
+            auto type = types.find(arg);
+            if (type == types.end() || !type->second) return false;
+            site->args.emplace_back(slot(arg), type->second);
+        }
+        as.mov(RDI, RBP);
+        as.movImm(RSI, reinterpret_cast<int64_t>(site.get()));
+        callHelper(reinterpret_cast<const void*>(&JitPrint));
+        printSites.push_back(std::move(site));
+        return true;
+    }
+
+    void emitBinOp(const ir::BinaryOp& bin) {
+        int32_t dest = slot(bin.dest->name), lhs = slot(bin.lhs->name), rhs = slot(bin.rhs->name);
+        if (bin.op == ir::Div) {
+            as.load(RDI, RBP, lhs);
+            as.load(RSI, RBP, rhs);
+            callHelper(reinterpret_cast<const void*>(&JitDiv));
+            as.store(RBP, dest, RAX);
+            return;
+        }
+        as.load(RAX, RBP, lhs);
+        switch (bin.op) {
+            case ir::Add: as.alu(AluAdd, RAX, RBP, rhs); break;
+            case ir::Sub: as.alu(AluSub, RAX, RBP, rhs); break;
+            case ir::Mul: as.imul(RAX, RBP, rhs); break;
+            case ir::And: as.alu(AluAnd, RAX, RBP, rhs); break;
+            case ir::Or: as.alu(AluOr, RAX, RBP, rhs); break;
+            default: {
+                static const std::unordered_map<ir::BinaryOpType, Cond> conds = {
+                    {ir::Eq, CondE}, {ir::Lt, CondL}, {ir::Gt, CondG}, {ir::Le, CondLE}, {ir::Ge, CondGE}};
+                as.alu(AluCmp, RAX, RBP, rhs);
+                as.setcc(conds.at(bin.op), RAX);
+            }
+        }
+        as.store(RBP, dest, RAX);
+    }
+
+    bool emit(ir::Instruction& instr, ir::BasicBlock& bb, ir::BasicBlock* next) {
+        if (dynamic_cast<ir::Label*>(&instr) || dynamic_cast<ir::Nop*>(&instr)) {
+            return true;
+        } else if (auto fused = dynamic_cast<ir::Fused*>(&instr)) {  // interpreter superinstruction
+            return emit(*fused->first, bb, next) && emit(*fused->second, bb, next);
+        } else if (auto c = dynamic_cast<ir::Constant*>(&instr)) {
+            as.movImm(RAX, c->val);
+            as.store(RBP, slot(c->dest->name), RAX);
+        } else if (auto bin = dynamic_cast<ir::BinaryOp*>(&instr)) {
+            if (bin->op == ir::BinInvalid) return false;
+            emitBinOp(*bin);
+        } else if (auto un = dynamic_cast<ir::UnaryOp*>(&instr)) {
+            if (un->op != ir::Not) return false;
+            as.load(RAX, RBP, slot(un->src->name));
+            as.test(RAX, RAX);
+            as.setcc(CondE, RAX);
+            as.store(RBP, slot(un->dest->name), RAX);
+        } else if (auto id = dynamic_cast<ir::Id*>(&instr)) {
+            as.load(RAX, RBP, slot(id->src));
+            as.store(RBP, slot(id->dest->name), RAX);
+        } else if (dynamic_cast<ir::Jump*>(&instr)) {
+            fallThrough(bb.taken.lock().get(), next);
+        } else if (auto br = dynamic_cast<ir::Branch*>(&instr)) {
+            as.load(RAX, RBP, slot(br->cond->name));
+            as.test(RAX, RAX);
+            as.jcc(CondNE, blockLabels.at(bb.taken.lock().get()));
+            fallThrough(bb.notTaken.lock().get(), next);
+        } else if (auto call = dynamic_cast<ir::Call*>(&instr)) {
+            emitCall(*call);
+        } else if (auto ret = dynamic_cast<ir::Return*>(&instr)) {
+            if (ret->val)
+                as.load(RAX, RBP, slot(*ret->val));
+            else
+                as.xor32(RAX, RAX);
+            epilogue();
+        } else if (auto print = dynamic_cast<ir::Print*>(&instr)) {
+            return emitPrint(*print);
+        } else if (auto alloc = dynamic_cast<ir::Alloc*>(&instr)) {
+            as.mov(RDI, RBX);
+            as.load(RSI, RBP, slot(alloc->size));
+            callHelper(reinterpret_cast<const void*>(&JitAlloc));
+            as.store(RBP, slot(alloc->dest->name), RAX);
+        } else if (auto free = dynamic_cast<ir::Free*>(&instr)) {
+            as.mov(RDI, RBX);
+            as.load(RSI, RBP, slot(free->site));
+            callHelper(reinterpret_cast<const void*>(&JitFree));
+        } else if (auto load = dynamic_cast<ir::Load*>(&instr); load && !load->checked) {
+            as.load(RAX, RBP, slot(load->ptr));
+            as.load(RAX, RAX, 0);
+            as.store(RBP, slot(load->dest->name), RAX);
+        } else if (auto store = dynamic_cast<ir::Store*>(&instr); store && !store->checked) {
+            as.load(RAX, RBP, slot(store->ptr));
+            as.load(RCX, RBP, slot(store->val));
+            as.store(RAX, 0, RCX);
+        } else if (auto load = dynamic_cast<ir::Load*>(&instr)) {
+            as.mov(RDI, RBX);
+            as.load(RSI, RBP, slot(load->ptr));
+            callHelper(reinterpret_cast<const void*>(&JitLoad));
+            as.store(RBP, slot(load->dest->name), RAX);
+        } else if (auto store = dynamic_cast<ir::Store*>(&instr)) {
+            as.mov(RDI, RBX);
+            as.load(RSI, RBP, slot(store->ptr));
+            as.load(RDX, RBP, slot(store->val));
+            callHelper(reinterpret_cast<const void*>(&JitStore));
+        } else if (auto ptrAdd = dynamic_cast<ir::PtrAdd*>(&instr)) {
+            as.load(RAX, RBP, slot(ptrAdd->ptr));
+            as.load(RCX, RBP, slot(ptrAdd->offset));
+            as.leaScaled(RAX, RAX, RCX);
+            as.store(RBP, slot(ptrAdd->dest->name), RAX);
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+}  // namespace
+
+JitEngine::JitEngine(ir::Program& prog, PerfMap* perf) : prog(prog), perf(perf) {
+    size_t maxArgs = 1;
+    for (const auto& func : prog.functions) {
+        func->MarkTailCalls();
+        records[func.get()] = std::make_unique<JitFunction>(JitFunction{&InterpretEntry, func.get()});
+        maxArgs = std::max(maxArgs, func->args.size());
+    }
+    tailArgs.resize(maxArgs);
+}
+
+bool JitEngine::compile(ir::Function& func) {
+    JitFunction& rec = record(func);
+    if (rec.code) return true;
+    std::vector<std::unique_ptr<PrintSite>> sites;
+    FunctionCompiler compiler(func, *this, sites);
+    if (!compiler.compile()) return false;
+    code.push_back(std::make_unique<ExecutableCode>(compiler.code(), PrologueCFI));
+    std::move(sites.begin(), sites.end(), std::back_inserter(printSites));
+    rec.code = code.back()->start();
+    if (perf) perf->add(rec.code, code.back()->size(), compiler.regions());
+    rec.entry = reinterpret_cast<EntryFn>(const_cast<uint8_t*>(rec.code));
+    if (auto offset = compiler.osrOffset()) {
+        OsrInfo info = compiler.takeOsrInfo();
+        info.entry = reinterpret_cast<OsrFn>(const_cast<uint8_t*>(rec.code + *offset));
+        osrInfo[&func] = std::move(info);
+    }
+    return true;
+}
+
+void JitEngine::compileAll() {
+    for (const auto& func : prog.functions) compile(*func);
+}
+
+std::optional<int64_t> JitEngine::run(ir::varContext& vars, ir::HeapManager& heap) {
+    if (!prog.mainFunc) throw std::runtime_error("error: main function not found");
+    return invoke(*prog.mainFunc, vars, heap);
+}
+
+bool JitEngine::hasOsrEntry(const ir::Function& func, const ir::BasicBlock& header) const {
+    auto info = osrInfo.find(&func);
+    return info != osrInfo.end() && info->second.headers.contains(&header);
+}
+
+std::optional<int64_t> JitEngine::enterAt(ir::Function& func, const ir::BasicBlock& header, const ir::varContext& vars, const std::unordered_set<std::string>& live, ir::HeapManager& heap) {
+    const OsrInfo& info = osrInfo.at(&func);
+    std::vector<int64_t> frame(info.numSlots);
+    for (const auto& name : live) {
+        auto val = vars.find(name);
+        auto index = info.slotIndex.find(name);
+        if (val != vars.end() && index != info.slotIndex.end()) frame[index->second] = val->second.value;
+    }
+    JitContext ctx{&heap, tailArgs.data()};
+    int64_t ret = info.entry(frame.data(), &ctx, &record(func), info.headers.at(&header));
+    if (!func.getRetType()) return std::nullopt;
+    return ret;
+}
+
+std::optional<int64_t> JitEngine::invoke(ir::Function& func, const ir::varContext& vars, ir::HeapManager& heap) {
+    JitFunction& rec = record(func);
+    std::vector<int64_t> args;
+    for (const auto& arg : func.args) args.push_back(vars.at(arg->name).value);
+    JitContext ctx{&heap, tailArgs.data()};
+    int64_t ret = rec.entry(args.data(), &ctx, &rec);
+    if (!func.getRetType()) return std::nullopt;
+    return ret;
+}
+
+}  // namespace jit
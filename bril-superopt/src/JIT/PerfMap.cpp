@@ -0,0 +1,113 @@
+#include <JIT/PerfMap.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <ctime>
+#include <format>
+#include <stdexcept>
+
+namespace jit {
+
+namespace {
+
+// jitdump format, see tools/perf/Documentation/jitdump-specification.txt
+constexpr uint32_t JitdumpMagic = 0x4A695444;
+constexpr uint32_t JitdumpVersion = 1;
+constexpr uint32_t ElfMachX86_64 = 62;
+constexpr uint32_t JitCodeLoad = 0, JitCodeClose = 3;
+
+struct FileHeader {
+    uint32_t magic, version, totalSize, elfMach, pad, pid;
+    uint64_t timestamp, flags;
+};
+
+struct RecordHeader {
+    uint32_t id, totalSize;
+    uint64_t timestamp;
+};
+
+struct CodeLoad {
+    RecordHeader header;
+    uint32_t pid, tid;
+    uint64_t vma, codeAddr, codeSize, codeIndex;
+    // followed by the NUL-terminated name and the code bytes
+};
+
+// perf record -k mono timestamps samples with this clock
+uint64_t Timestamp() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void WriteAll(int fd, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0) throw std::runtime_error("error: jit: cannot write the jitdump file");
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+}  // namespace
+
+PerfMap::PerfMap(bool jitdump) {
+    std::string path = std::format("/tmp/perf-{}.map", getpid());
+    map.open(path, std::ios::app);
+    if (!map) throw std::runtime_error("error: jit: cannot write " + path);
+    if (!jitdump) return;
+    path = std::format("/tmp/jit-{}.dump", getpid());
+    dumpFd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+    if (dumpFd < 0) throw std::runtime_error("error: jit: cannot write " + path);
+    // perf finds the dump through an executable mapping of its first page
+    markerSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    marker = mmap(nullptr, markerSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, dumpFd, 0);
+    if (marker == MAP_FAILED) {
+        marker = nullptr;
+        close(dumpFd);
+        dumpFd = -1;
+        throw std::runtime_error("error: jit: cannot map " + path);
+    }
+    FileHeader header{JitdumpMagic, JitdumpVersion, sizeof(FileHeader), ElfMachX86_64, 0, static_cast<uint32_t>(getpid()), Timestamp(), 0};
+    WriteAll(dumpFd, &header, sizeof(header));
+}
+
+PerfMap::~PerfMap() {
+    if (dumpFd < 0) return;
+    RecordHeader close{JitCodeClose, sizeof(RecordHeader), Timestamp()};
+    [[maybe_unused]] auto written = write(dumpFd, &close, sizeof(close));
+    munmap(marker, markerSize);
+    ::close(dumpFd);
+}
+
+void PerfMap::add(const uint8_t* code, size_t size, const std::vector<std::pair<size_t, std::string>>& regions) {
+    for (size_t i = 0; i < regions.size(); i++) {
+        const auto& [start, name] = regions[i];
+        size_t end = i + 1 < regions.size() ? regions[i + 1].first : size;
+        if (end <= start) continue;
+        map << std::format("{:x} {:x} {}\n", reinterpret_cast<uintptr_t>(code + start), end - start, name);
+        if (dumpFd >= 0) dump(code + start, end - start, name);
+    }
+    // a run may be profiled while it is still going, or die in a trap
+    map.flush();
+}
+
+void PerfMap::dump(const uint8_t* code, size_t size, const std::string& name) {
+    CodeLoad load{};
+    load.header = {JitCodeLoad, static_cast<uint32_t>(sizeof(CodeLoad) + name.size() + 1 + size), Timestamp()};
+    load.pid = static_cast<uint32_t>(getpid());
+    load.tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    load.vma = load.codeAddr = reinterpret_cast<uint64_t>(code);
+    load.codeSize = size;
+    load.codeIndex = codeIndex++;
+    WriteAll(dumpFd, &load, sizeof(load));
+    WriteAll(dumpFd, name.c_str(), name.size() + 1);
+    WriteAll(dumpFd, code, size);
+}
+
+}  // namespace jit
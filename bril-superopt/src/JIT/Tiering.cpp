@@ -0,0 +1,67 @@
+#include <Analysis/Liveness.h>
+#include <Analysis/Loops.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Heap.h>
+#include <IR/Program.h>
+#include <JIT/Jit.h>
+#include <JIT/Tiering.h>
+
+#include <chrono>
+#include <format>
+#include <iostream>
+
+namespace jit {
+
+TieredEngine::TieredEngine(ir::Program& prog, const TierParams& params) : prog(prog), engine(prog, params.perfMap), log(params.log) {
+    callThreshold = params.callThreshold;
+    backEdgeThreshold = params.backEdgeThreshold;
+    for (const auto& func : prog.functions) {
+        opt::MarkLoops(*func);
+        func->tier = this;
+    }
+}
+
+TieredEngine::~TieredEngine() {
+    for (const auto& func : prog.functions) {
+        func->tier = nullptr;
+        func->native = nullptr;
+    }
+}
+
+bool TieredEngine::promote(ir::Function& func) {
+    if (func.native) return true;
+    if (rejected.contains(&func)) return false;
+    auto start = std::chrono::steady_clock::now();
+    bool compiled = engine.compile(func);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    if (log)
+        std::cerr << std::format("tier-up: @{} after {} calls, {} back edges: {}\n", func.name, func.calls, func.backEdges,
+                                 compiled ? std::format("compiled in {}us", micros) : std::string("not compilable"));
+    if (!compiled) {
+        rejected.insert(&func);
+        return false;
+    }
+    func.native = [this, &func](ir::varContext& vars, ir::HeapManager& heap) {
+        return engine.invoke(func, vars, heap);
+    };
+    return true;
+}
+
+bool TieredEngine::enterLoop(ir::Function& func, ir::BasicBlock& header, ir::varContext& vars, ir::HeapManager& heap, std::optional<int64_t>& ret) {
+    if (!engine.hasOsrEntry(func, header)) return false;
+    auto live = liveness.find(&func);
+    if (live == liveness.end()) live = liveness.emplace(&func, opt::Liveness(func)).first;
+    if (log && !osrLogged.contains(&func)) {
+        std::cerr << std::format("osr: @{} entering compiled code at a loop header\n", func.name);
+        osrLogged.insert(&func);
+    }
+    ret = engine.enterAt(func, header, vars, live->second.liveIn(&header), heap);
+    return true;
+}
+
+std::optional<int64_t> TieredEngine::run(ir::varContext& vars, ir::HeapManager& heap) {
+    return prog.execute(vars, heap);
+}
+
+}  // namespace jit
@@ -0,0 +1,163 @@
+#include <Analysis/Loops.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Heap.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+#include <Trace/Tracer.h>
+#include <Transform/Fuse.h>
+
+#include <format>
+#include <iostream>
+
+namespace trace {
+
+namespace {
+
+using namespace ir;
+
+// recordings given up on before an anchor is left to the interpreter for good
+constexpr int MaxAborts = 3;
+
+}  // namespace
+
+TraceEngine::TraceEngine(ir::Program& prog, const TraceParams& params) : prog(prog), params(params) {
+    for (const auto& func : prog.functions) {
+        opt::MarkLoops(*func);
+        func->tracer = this;
+    }
+}
+
+TraceEngine::~TraceEngine() {
+    for (const auto& func : prog.functions) func->tracer = nullptr;
+}
+
+ir::BBPtr TraceEngine::transition(ir::Function& func, ir::BasicBlock& from, ir::BBPtr to, ir::varContext& vars, ir::HeapManager& heap) {
+    if (recording) {
+        record(func, from, to);
+        if (recording) return to;
+    }
+    if (auto it = byAnchor.find(to.get()); it != byAnchor.end()) return execute(it->second, vars, heap);
+    if (from.loopLatch && to->loopHeader && ++backEdges[to.get()] == params.loopThreshold) startRecording(func, to, nullptr);
+    return to;
+}
+
+std::optional<int64_t> TraceEngine::run(ir::varContext& vars, ir::HeapManager& heap) {
+    return prog.execute(vars, heap);
+}
+
+ir::BBPtr TraceEngine::execute(Trace* trace, ir::varContext& vars, ir::HeapManager& heap) {
+    while (true) {
+        Trace* next = trace->link;
+        for (const auto& step : trace->steps) {
+            auto status = step.instr->execute(vars, heap);
+            if (step.guard < 0) continue;
+            auto& guard = trace->guards[step.guard];
+            if (status.getTaken() == guard.expected) continue;
+            if (!guard.side)
+                if (auto it = byAnchor.find(guard.exit.get()); it != byAnchor.end()) guard.side = it->second;
+            if (!guard.side) {
+                if (++guard.failures == params.exitThreshold && !recording) startRecording(*trace->func, guard.exit, &guard);
+                return guard.exit;
+            }
+            next = guard.side;
+            break;
+        }
+        if (!next) return trace->next;
+        trace = next;
+    }
+}
+
+void TraceEngine::startRecording(ir::Function& func, ir::BBPtr anchor, Guard* sideOf) {
+    if (recording || aborts[anchor.get()] >= MaxAborts) return;
+    const auto* start = anchor.get();
+    recording = Recording{&func, std::move(anchor), sideOf, {}, start};
+}
+
+void TraceEngine::abortRecording() {
+    auto& rec = *recording;
+    if (++aborts[rec.anchor.get()] < MaxAborts) {  // try again once it is as hot again
+        if (rec.sideOf)
+            rec.sideOf->failures = 0;
+        else
+            backEdges[rec.anchor.get()] = 0;
+    }
+    if (params.log)
+        std::cerr << std::format("trace: @{} {} abandoned\n", rec.func->name, rec.func->blockName(*rec.anchor));
+    recording.reset();
+}
+
+void TraceEngine::record(ir::Function& func, ir::BasicBlock& from, const ir::BBPtr& to) {
+    auto& rec = *recording;
+    if (&func != rec.func || &from != rec.expected) {
+        // a callee is running, or the recorded activation left the path
+        // through a call or return: give up on the latter
+        if (&func == rec.func || ++rec.foreign > params.maxBlocks * 1024) abortRecording();
+        return;
+    }
+    rec.foreign = 0;
+    rec.path.emplace_back(&from, to);
+    rec.expected = to.get();
+    auto linked = byAnchor.find(to.get());
+    if (to != rec.anchor && linked == byAnchor.end()) {
+        if (rec.path.size() >= params.maxBlocks) abortRecording();
+        return;
+    }
+    auto* trace = lower(rec);
+    trace->link = to == rec.anchor ? trace : linked->second;
+    if (rec.sideOf) rec.sideOf->side = trace;
+    byAnchor.try_emplace(rec.anchor.get(), trace);
+    if (params.log)
+        std::cerr << std::format("trace: @{} {} recorded {} blocks, {} guards, {} steps{}\n", func.name, func.blockName(*rec.anchor),
+                                 rec.path.size(), trace->guards.size(), trace->steps.size(),
+                                 rec.sideOf ? " (side exit)" : "");
+    recording.reset();
+}
+
+TraceEngine::Trace* TraceEngine::lower(const Recording& rec) {
+    auto trace = std::make_unique<Trace>();
+    trace->func = rec.func;
+    trace->anchor = rec.anchor;
+    trace->next = rec.path.back().second;
+    std::vector<InstPtr> instrs;
+    std::vector<int> guards;
+    for (const auto& [bb, succ] : rec.path) {
+        auto taken = bb->taken.lock(), notTaken = bb->notTaken.lock();
+        for (const auto& instr : bb->instrs) {
+            if (dynamic_cast<Label*>(instr.get()) || dynamic_cast<Nop*>(instr.get()) || dynamic_cast<Jump*>(instr.get())) continue;
+            bool branch = dynamic_cast<Branch*>(instr.get());
+            auto* cmpBranch = dynamic_cast<CompareBranch*>(instr.get());
+            if ((branch || cmpBranch) && taken == notTaken) {  // both ways lead to the same block
+                if (cmpBranch && cmpBranch->keep) {
+                    instrs.push_back(cmpBranch->cmp);
+                    guards.push_back(-1);
+                }
+                continue;
+            }
+            int guard = -1;
+            if (branch || cmpBranch) {
+                bool expected = succ == taken;
+                trace->guards.push_back(Guard{expected, expected ? notTaken : taken});
+                guard = trace->guards.size() - 1;
+            }
+            instrs.push_back(instr);
+            guards.push_back(guard);
+        }
+    }
+    // with the labels gone, pairs that used to straddle a block boundary fuse
+    // too; a fused pair takes over the guard of its second half
+    for (size_t i = 0; i < instrs.size(); i++) {
+        if (i + 1 < instrs.size() && guards[i] < 0)
+            if (auto pair = opt::FusePair(instrs[i], instrs[i + 1])) {
+                trace->steps.push_back(Step{pair.get(), guards[i + 1]});
+                trace->fused.push_back(std::move(pair));
+                i++;
+                continue;
+            }
+        trace->steps.push_back(Step{instrs[i].get(), guards[i]});
+    }
+    traces.push_back(std::move(trace));
+    return traces.back().get();
+}
+
+}  // namespace trace
@@ -0,0 +1,40 @@
+#include <Analysis/Ranges.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <Transform/BoundsCheck.h>
+
+#include <memory>
+
+namespace opt {
+
+bool ElideBoundsChecks(ir::Function& func) {
+    auto safe = SafeAccesses(func);
+    bool changed = false;
+    for (const auto& bb : func.basicBlocks) {
+        for (const auto& instr : bb->instrs) {
+            if (!safe.contains(instr.get())) continue;
+            if (auto load = std::dynamic_pointer_cast<ir::Load>(instr)) {
+                changed |= load->checked;
+                load->checked = false;
+            } else if (auto store = std::dynamic_pointer_cast<ir::Store>(instr)) {
+                changed |= store->checked;
+                store->checked = false;
+            }
+        }
+    }
+    return changed;
+}
+
+void RestoreBoundsChecks(ir::Function& func) {
+    for (const auto& bb : func.basicBlocks) {
+        for (const auto& instr : bb->instrs) {
+            if (auto load = std::dynamic_pointer_cast<ir::Load>(instr))
+                load->checked = true;
+            else if (auto store = std::dynamic_pointer_cast<ir::Store>(instr))
+                store->checked = true;
+        }
+    }
+}
+
+}  // namespace opt
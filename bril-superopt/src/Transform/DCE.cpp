@@ -0,0 +1,40 @@
+#include <Analysis/Liveness.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <Transform/DCE.h>
+
+#include <algorithm>
+#include <ranges>
+#include <vector>
+
+namespace opt {
+
+bool DCE(ir::Function& func) {
+    bool changed = false;
+    // removing a use in one block can kill a definition in another
+    for (bool progress = true; progress; changed |= progress) {
+        progress = false;
+        Liveness liveness(func);
+        for (auto& bb : func.basicBlocks) {
+            VarSet live = liveness.liveOut(bb.get());
+            std::vector<ir::InstPtr> kept;
+            for (const auto& instr : bb->instrs | std::views::reverse) {
+                bool dead = instr->isPure() && std::ranges::none_of(instr->defs(), [&](const auto& def) {
+                                return live.contains(def);
+                            });
+                if (dead) {
+                    progress = true;
+                    continue;
+                }
+                StepLiveness(*instr, live);
+                kept.push_back(instr);
+            }
+            std::ranges::reverse(kept);
+            bb->instrs = std::move(kept);
+        }
+    }
+    return changed;
+}
+
+}  // namespace opt
@@ -0,0 +1,117 @@
+#include <Analysis/PointsTo.h>
+#include <Analysis/Ranges.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <Transform/DSE.h>
+
+#include <algorithm>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+// allocation sites no load can observe
+std::vector<bool> WriteOnlySites(const Function& func, const PointsTo& pointsTo) {
+    std::vector<bool> writeOnly(pointsTo.sites.size());
+    for (size_t site = 0; site < writeOnly.size(); site++) writeOnly[site] = !pointsTo.escapes(site);
+    for (const auto& bb : func.basicBlocks) {
+        for (const auto& instr : bb->instrs) {
+            auto load = std::dynamic_pointer_cast<Load>(instr);
+            if (!load) continue;
+            for (int site : pointsTo.pointees(load->ptr))
+                if (site != PointsTo::UnknownSite) writeOnly[site] = false;
+        }
+    }
+    return writeOnly;
+}
+
+bool StoresOnlyInto(const PointsTo& pointsTo, const std::vector<bool>& writeOnly, const std::string& ptr) {
+    const auto& pointees = pointsTo.pointees(ptr);
+    return !pointees.empty() && std::ranges::all_of(pointees, [&](int site) {
+        return site != PointsTo::UnknownSite && writeOnly[site];
+    });
+}
+
+// Block-local part. A forward walk numbers the objects pointer operands refer to
+// (ptradd and id keep the object of their source), a backward walk then tracks
+// the objects freed later in the block that nothing may read before the free.
+bool RemoveStoresBeforeFree(BasicBlock& bb, const PointsTo& pointsTo, const std::unordered_set<const Instruction*>& safe) {
+    struct Object {
+        std::string repr;  // a variable naming it, for alias queries
+    };
+    std::vector<Object> objects;
+    std::unordered_map<std::string, int> objectOf;
+    auto lookup = [&](const std::string& var) {
+        if (auto it = objectOf.find(var); it != objectOf.end()) return it->second;
+        objects.push_back({var});
+        return objectOf[var] = objects.size() - 1;
+    };
+    std::vector<int> operandObject(bb.instrs.size(), -1);
+    for (size_t i = 0; i < bb.instrs.size(); i++) {
+        const auto& instr = bb.instrs[i];
+        if (auto store = std::dynamic_pointer_cast<Store>(instr)) {
+            operandObject[i] = lookup(store->ptr);
+        } else if (auto free = std::dynamic_pointer_cast<Free>(instr)) {
+            operandObject[i] = lookup(free->site);
+        } else if (auto ptrAdd = std::dynamic_pointer_cast<PtrAdd>(instr)) {
+            objectOf[ptrAdd->dest->name] = lookup(ptrAdd->ptr);
+            continue;
+        } else if (auto id = std::dynamic_pointer_cast<Id>(instr)) {
+            objectOf[id->dest->name] = lookup(id->src);
+            continue;
+        }
+        for (const auto& def : instr->defs()) objectOf.erase(def);
+    }
+
+    bool changed = false;
+    std::unordered_set<int> freed;
+    std::vector<InstPtr> kept;
+    for (size_t i = bb.instrs.size(); i-- > 0;) {
+        const auto& instr = bb.instrs[i];
+        if (std::dynamic_pointer_cast<Free>(instr)) {
+            freed.insert(operandObject[i]);
+        } else if (std::dynamic_pointer_cast<Store>(instr) && freed.contains(operandObject[i]) && safe.contains(instr.get())) {
+            changed = true;
+            continue;
+        } else if (auto load = std::dynamic_pointer_cast<Load>(instr)) {
+            std::erase_if(freed, [&](int obj) { return pointsTo.mayAlias(objects[obj].repr, load->ptr); });
+        } else if (std::dynamic_pointer_cast<Call>(instr)) {
+            std::erase_if(freed, [&](int obj) {
+                return std::ranges::any_of(pointsTo.pointees(objects[obj].repr), [&](int site) { return pointsTo.escapes(site); });
+            });
+        }
+        kept.push_back(instr);
+    }
+    std::ranges::reverse(kept);
+    bb.instrs = std::move(kept);
+    return changed;
+}
+
+}  // namespace
+
+bool DSE(Function& func) {
+    PointsTo pointsTo(func);
+    auto writeOnly = WriteOnlySites(func, pointsTo);
+    // a store that may be out of bounds fails when run, so it is never dead
+    auto safe = SafeAccesses(func);
+    bool changed = false;
+    for (auto& bb : func.basicBlocks) {
+        changed |= std::erase_if(bb->instrs, [&](const InstPtr& instr) {
+                       auto store = std::dynamic_pointer_cast<Store>(instr);
+                       return store && safe.contains(store.get()) && StoresOnlyInto(pointsTo, writeOnly, store->ptr);
+                   }) > 0;
+        changed |= RemoveStoresBeforeFree(*bb, pointsTo, safe);
+    }
+    return changed;
+}
+
+}  // namespace opt
@@ -0,0 +1,68 @@
+#include <Analysis/Liveness.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <Transform/Fuse.h>
+
+#include <memory>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+bool IsCompare(BinaryOpType op) {
+    return op == Eq || op == Lt || op == Gt || op == Le || op == Ge;
+}
+
+}  // namespace
+
+InstPtr FusePair(const InstPtr& first, const InstPtr& second, const VarSet* live) {
+    auto keep = [live](const VarPtr& var) { return !live || live->contains(var->name); };
+    if (auto cmp = std::dynamic_pointer_cast<BinaryOp>(first); cmp && IsCompare(cmp->op)) {
+        if (auto branch = std::dynamic_pointer_cast<Branch>(second); branch && branch->cond->name == cmp->dest->name)
+            return std::make_shared<CompareBranch>(cmp, branch, keep(cmp->dest));
+    }
+    if (auto c = std::dynamic_pointer_cast<Constant>(first)) {
+        auto op = std::dynamic_pointer_cast<BinaryOp>(second);
+        if (op && op->op != BinInvalid && (op->lhs->name == c->dest->name || op->rhs->name == c->dest->name))
+            return std::make_shared<ConstBinaryOp>(c, op, keep(c->dest));
+    }
+    if (auto ptrAdd = std::dynamic_pointer_cast<PtrAdd>(first)) {
+        if (auto load = std::dynamic_pointer_cast<Load>(second); load && load->ptr == ptrAdd->dest->name)
+            return std::make_shared<PtrAddLoad>(ptrAdd, load, keep(ptrAdd->dest));
+    }
+    return nullptr;
+}
+
+bool FuseInstructions(Function& func) {
+    Liveness liveness(func);
+    bool changed = false;
+    for (const auto& bb : func.basicBlocks) {
+        auto& instrs = bb->instrs;
+        std::vector<VarSet> liveAfter(instrs.size());
+        VarSet live = liveness.liveOut(bb.get());
+        for (size_t i = instrs.size(); i-- > 0;) {
+            liveAfter[i] = live;
+            StepLiveness(*instrs[i], live);
+        }
+        std::vector<InstPtr> fused;
+        for (size_t i = 0; i < instrs.size(); i++) {
+            if (i + 1 < instrs.size()) {
+                if (auto pair = FusePair(instrs[i], instrs[i + 1], &liveAfter[i + 1])) {
+                    fused.push_back(pair);
+                    changed = true;
+                    i++;
+                    continue;
+                }
+            }
+            fused.push_back(instrs[i]);
+        }
+        instrs = std::move(fused);
+    }
+    return changed;
+}
+
+}  // namespace opt
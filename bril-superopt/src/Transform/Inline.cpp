@@ -0,0 +1,192 @@
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+#include <Transform/Inline.h>
+#include <Transform/LoopUtils.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+size_t Size(const Function& func) {
+    size_t size = 0;
+    for (const auto& bb : func.basicBlocks)
+        for (const auto& instr : bb->instrs)
+            if (!std::dynamic_pointer_cast<Label>(instr)) size++;
+    return size;
+}
+
+// callees before callers, cycles broken arbitrarily
+std::vector<Function*> BottomUpOrder(const Program& prog) {
+    std::vector<Function*> order;
+    std::unordered_set<const Function*> visited;
+    std::function<void(Function*)> visit = [&](Function* func) {
+        if (!visited.insert(func).second) return;
+        for (const auto& bb : func->basicBlocks)
+            for (const auto& instr : bb->instrs)
+                if (auto call = std::dynamic_pointer_cast<Call>(instr))
+                    if (auto callee = call->func.lock()) visit(callee.get());
+        order.push_back(func);
+    };
+    for (const auto& func : prog.functions) visit(func.get());
+    return order;
+}
+
+// a prefix no variable or label of 'func' starts with
+std::string FreshPrefix(const Function& func, const std::string& calleeName, int& counter) {
+    std::unordered_set<std::string> names;
+    for (const auto& arg : func.args) names.insert(arg->name);
+    for (const auto& bb : func.basicBlocks) {
+        for (const auto& instr : bb->instrs) {
+            for (const auto& name : instr->uses()) names.insert(name);
+            for (const auto& name : instr->defs()) names.insert(name);
+            if (auto label = std::dynamic_pointer_cast<Label>(instr)) names.insert(label->name);
+        }
+    }
+    while (true) {
+        std::string prefix = calleeName + "." + std::to_string(counter++) + ".";
+        if (std::ranges::none_of(names, [&](const std::string& name) { return name.starts_with(prefix); }))
+            return prefix;
+    }
+}
+
+bool ShouldInline(const Call& call, const Function& caller, const Function& callee, size_t callerSize,
+                  const InlineParams& params) {
+    if (&callee == &caller) return false;
+    size_t cost = Size(callee);
+    if (callerSize + cost > params.maxFunctionSize) return false;
+    if (!params.useProfile) return cost <= params.sizeThreshold;
+    if (call.hits == 0) return false;
+    return cost <= (call.hits >= params.hotCount ? params.hotSizeThreshold : params.sizeThreshold);
+}
+
+// inline the call at caller.basicBlocks[blockIdx]->instrs[instrIdx], returns
+// the index of the continuation block
+size_t InlineCallSite(Function& caller, size_t blockIdx, size_t instrIdx, const Function& callee, const std::string& prefix) {
+    BBPtr bb = caller.basicBlocks[blockIdx];
+    auto call = std::static_pointer_cast<Call>(bb->instrs[instrIdx]);
+    // 'call; ret' of the result: the callee's returns can stay returns, which
+    // keeps the calls in tail position inside its body in tail position
+    auto next = instrIdx + 1 < bb->instrs.size() ? std::dynamic_pointer_cast<Return>(bb->instrs[instrIdx + 1]) : nullptr;
+    bool tail = next && (next->val ? call->dest && call->dest->name == *next->val : !call->dest);
+    Renamer rename = [&](const std::string& name) { return prefix + name; };
+    // parameters the callee never assigns read the caller's arguments
+    // directly: nothing in the inlined code assigns those before it leaves
+    std::unordered_map<std::string, std::string> forwarded;
+    for (size_t i = 0; i < callee.args.size(); i++) forwarded[callee.args[i]->name] = call->args[i];
+    for (const auto& calleeBB : callee.basicBlocks)
+        for (const auto& instr : calleeBB->instrs)
+            for (const auto& def : instr->defs()) forwarded.erase(def);
+    Renamer renameVar = [&](const std::string& name) {
+        auto it = forwarded.find(name);
+        return it == forwarded.end() ? prefix + name : it->second;
+    };
+
+    // split everything after the call into the continuation block
+    std::unordered_set<std::string> calleeLabels;
+    for (const auto& calleeBB : callee.basicBlocks)
+        for (const auto& instr : calleeBB->instrs)
+            if (auto label = std::dynamic_pointer_cast<Label>(instr)) calleeLabels.insert(label->name);
+    std::string contName = "ret";
+    for (int i = 1; calleeLabels.contains(contName); i++) contName = "ret." + std::to_string(i);
+    auto cont = std::make_shared<BasicBlock>();
+    std::string contLabel = rename(contName);
+    cont->instrs.push_back(std::make_shared<Label>(contLabel));
+    cont->instrs.insert(cont->instrs.end(), bb->instrs.begin() + instrIdx + 1, bb->instrs.end());
+    cont->taken = bb->taken;
+    cont->notTaken = bb->notTaken;
+    bb->instrs.resize(instrIdx);
+    for (size_t i = 0; i < callee.args.size(); i++) {
+        if (forwarded.contains(callee.args[i]->name)) continue;
+        auto param = std::make_shared<Variable>(rename(callee.args[i]->name), callee.args[i]->type);
+        bb->instrs.push_back(std::make_shared<Id>(param, call->args[i]));
+    }
+
+    std::unordered_map<const BasicBlock*, BBPtr> cloneOf;
+    std::vector<BBPtr> clones;
+    for (const auto& calleeBB : callee.basicBlocks) {
+        auto clone = std::make_shared<BasicBlock>();
+        for (const auto& instr : calleeBB->instrs) clone->instrs.push_back(instr->clone(renameVar, rename));
+        cloneOf[calleeBB.get()] = clone;
+        clones.push_back(clone);
+    }
+    for (const auto& calleeBB : callee.basicBlocks) {
+        BBPtr clone = cloneOf[calleeBB.get()];
+        if (auto taken = calleeBB->taken.lock()) clone->taken = cloneOf.at(taken.get());
+        if (auto notTaken = calleeBB->notTaken.lock()) clone->notTaken = cloneOf.at(notTaken.get());
+        auto ret = clone->instrs.empty() ? nullptr : std::dynamic_pointer_cast<Return>(clone->instrs.back());
+        if (ret && tail) {
+            if (!call->dest) clone->instrs.back() = std::make_shared<Return>(std::nullopt);  // the result was dropped
+        } else if (ret) {
+            clone->instrs.pop_back();
+            if (ret->val && call->dest) clone->instrs.push_back(std::make_shared<Id>(call->dest, *ret->val));
+            clone->instrs.push_back(std::make_shared<Jump>(contLabel));
+            clone->taken = cont;
+        } else if (!calleeBB->taken.lock() && !calleeBB->notTaken.lock()) {
+            clone->notTaken = cont;  // falling off the end of the callee, laid out before 'cont'
+        }
+    }
+    bb->taken.reset();
+    bb->notTaken = clones.empty() ? cont : clones.front();  // the callee entry comes first
+
+    auto pos = caller.basicBlocks.begin() + blockIdx + 1;
+    pos = caller.basicBlocks.insert(pos, clones.begin(), clones.end());
+    caller.basicBlocks.insert(pos + clones.size(), cont);
+    return blockIdx + clones.size() + 1;
+}
+
+// inline the calls of 'caller' that 'select' accepts
+bool InlineSelected(Function& caller, const CallSelector& select, int& counter) {
+    bool changed = false;
+    for (size_t b = 0; b < caller.basicBlocks.size(); b++) {
+        auto& instrs = caller.basicBlocks[b]->instrs;
+        for (size_t i = 0; i < instrs.size(); i++) {
+            auto call = std::dynamic_pointer_cast<Call>(instrs[i]);
+            auto callee = call ? call->func.lock() : nullptr;
+            if (!callee || callee.get() == &caller || !select(*call, *callee)) continue;
+            std::string prefix = FreshPrefix(caller, callee->name, counter);
+            // continue in the continuation block: calls cloned in from the
+            // callee are not visited again (Inline has already processed it)
+            b = InlineCallSite(caller, b, i, *callee, prefix) - 1;
+            changed = true;
+            break;
+        }
+    }
+    return changed;
+}
+
+}  // namespace
+
+bool Inline(Program& prog, const InlineParams& params) {
+    bool changed = false;
+    int counter = 0;
+    for (Function* func : BottomUpOrder(prog)) {
+        size_t callerSize = Size(*func);
+        changed |= InlineSelected(*func, [&](const Call& call, const Function& callee) {
+            if (!ShouldInline(call, *func, callee, callerSize, params)) return false;
+            callerSize += Size(callee);
+            return true;
+        }, counter);
+    }
+    return changed;
+}
+
+bool InlineCalls(Function& caller, const CallSelector& select) {
+    int counter = 0;
+    return InlineSelected(caller, select, counter);
+}
+
+}  // namespace opt
@@ -0,0 +1,126 @@
+#include <Analysis/Dominators.h>
+#include <Analysis/Liveness.h>
+#include <Analysis/Loops.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <Transform/LICM.h>
+#include <Transform/LoopUtils.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+struct Def {
+    const BasicBlock* bb;
+    InstPtr instr;
+};
+
+// the single definition of every variable defined exactly once in 'func'
+std::unordered_map<std::string, Def> UniqueDefs(const Function& func) {
+    std::unordered_map<std::string, Def> defs;
+    std::unordered_set<std::string> multiple;
+    for (const auto& arg : func.args) multiple.insert(arg->name);
+    for (const auto& bb : func.basicBlocks)
+        for (const auto& instr : bb->instrs)
+            for (const auto& def : instr->defs())
+                if (!defs.try_emplace(def, Def{bb.get(), instr}).second) multiple.insert(def);
+    for (const auto& name : multiple) defs.erase(name);
+    return defs;
+}
+
+// executing 'instr' early cannot fail or have a visible effect
+bool IsSpeculatable(const InstPtr& instr, const Loop& loop, const DominatorTree& domTree,
+                    const std::unordered_map<std::string, Def>& uniqueDefs) {
+    if (!std::dynamic_pointer_cast<CoreComputeInst>(instr)) return false;
+    if (instr->isPure()) return true;
+    auto div = std::dynamic_pointer_cast<BinaryOp>(instr);
+    if (!div || div->op != BinaryOpType::Div) return false;
+    auto it = uniqueDefs.find(div->rhs->name);
+    if (it == uniqueDefs.end() || !domTree.dominates(it->second.bb, loop.header)) return false;
+    auto divisor = std::dynamic_pointer_cast<Constant>(it->second.instr);
+    return divisor && divisor->val != 0;
+}
+
+// invariant instructions of 'loop' in an order that respects their dependencies
+std::vector<InstPtr> FindInvariants(const Function& func, const Loop& loop, const DominatorTree& domTree,
+                                    const Liveness& liveness) {
+    auto uniqueDefs = UniqueDefs(func);
+    std::unordered_map<std::string, int> defsInLoop;
+    std::vector<BasicBlock*> blocks;
+    for (const auto& bb : func.basicBlocks) {
+        if (!loop.contains(bb.get())) continue;
+        blocks.push_back(bb.get());
+        for (const auto& instr : bb->instrs)
+            for (const auto& def : instr->defs()) defsInLoop[def]++;
+    }
+    std::vector<const BasicBlock*> exiting;
+    for (const auto* bb : blocks)
+        if (std::ranges::any_of(bb->successors(), [&](const BBPtr& succ) { return !loop.contains(succ.get()); }))
+            exiting.push_back(bb);
+    auto exits = loop.exitBlocks();
+
+    std::vector<InstPtr> invariants;
+    std::unordered_set<const Instruction*> hoisted;
+    for (bool progress = true; progress;) {
+        progress = false;
+        for (const auto* bb : blocks) {
+            for (const auto& instr : bb->instrs) {
+                if (hoisted.contains(instr.get()) || !IsSpeculatable(instr, loop, domTree, uniqueDefs)) continue;
+                if (std::ranges::any_of(instr->uses(), [&](const auto& use) { return defsInLoop[use] > 0; })) continue;
+                const std::string dest = instr->defs().front();
+                // the only definition in the loop, and no use can see an older value
+                if (defsInLoop[dest] != 1 || liveness.liveIn(loop.header).contains(dest)) continue;
+                bool alwaysRuns = std::ranges::all_of(exiting, [&](const BasicBlock* e) { return domTree.dominates(bb, e); });
+                bool deadOnExit = std::ranges::none_of(exits, [&](const BasicBlock* e) { return liveness.liveIn(e).contains(dest); });
+                if (!alwaysRuns && !deadOnExit) continue;
+                hoisted.insert(instr.get());
+                invariants.push_back(instr);
+                defsInLoop[dest] = 0;
+                progress = true;
+            }
+        }
+    }
+    return invariants;
+}
+
+}  // namespace
+
+bool LICM(Function& func) {
+    bool changed = false;
+    // every hoist may add a preheader, so the analyses are rebuilt per loop
+    std::unordered_set<const BasicBlock*> done;
+    while (true) {
+        DominatorTree domTree(func);
+        LoopInfo loopInfo(func, domTree);
+        auto order = loopInfo.postOrder();
+        auto it = std::ranges::find_if(order, [&](const Loop* loop) { return !done.contains(loop->header); });
+        if (it == order.end()) break;
+        const Loop& loop = **it;
+        done.insert(loop.header);
+
+        Liveness liveness(func);
+        auto invariants = FindInvariants(func, loop, domTree, liveness);
+        if (invariants.empty()) continue;
+        std::unordered_set<const Instruction*> moving;
+        for (const auto& instr : invariants) moving.insert(instr.get());
+        for (const auto& bb : func.basicBlocks)
+            if (loop.contains(bb.get()))
+                std::erase_if(bb->instrs, [&](const InstPtr& instr) { return moving.contains(instr.get()); });
+        BBPtr preheader = GetOrInsertPreheader(func, loop);
+        for (auto& instr : invariants) InsertBeforeTerminator(*preheader, instr);
+        changed = true;
+    }
+    return changed;
+}
+
+}  // namespace opt
@@ -0,0 +1,98 @@
+#include <Analysis/CFG.h>
+#include <Analysis/Loops.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <Transform/LoopUtils.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+using namespace ir;
+
+std::string FreshLabel(const Function& func, const std::string& hint) {
+    std::unordered_set<std::string> used;
+    for (const auto& bb : func.basicBlocks)
+        for (const auto& instr : bb->instrs)
+            if (auto label = std::dynamic_pointer_cast<Label>(instr)) used.insert(label->name);
+    std::string name = hint;
+    for (int i = 1; used.contains(name); i++) name = hint + "." + std::to_string(i);
+    return name;
+}
+
+std::string EnsureLabel(const Function& func, BasicBlock& bb, const std::string& hint) {
+    if (!bb.instrs.empty())
+        if (auto label = std::dynamic_pointer_cast<Label>(bb.instrs.front())) return label->name;
+    std::string name = FreshLabel(func, hint);
+    bb.instrs.insert(bb.instrs.begin(), std::make_shared<Label>(name));
+    return name;
+}
+
+void RedirectEdge(BasicBlock& from, const BasicBlock* oldSucc, const BBPtr& newSucc, const std::string& newLabel) {
+    InstPtr term = from.instrs.empty() ? nullptr : from.instrs.back();
+    if (auto jump = std::dynamic_pointer_cast<Jump>(term)) {
+        jump->target = newLabel;
+        from.taken = newSucc;
+    } else if (auto branch = std::dynamic_pointer_cast<Branch>(term)) {
+        if (from.taken.lock().get() == oldSucc) {
+            branch->ifTrue = newLabel;
+            from.taken = newSucc;
+        }
+        if (from.notTaken.lock().get() == oldSucc) {
+            branch->ifFalse = newLabel;
+            from.notTaken = newSucc;
+        }
+    } else if (from.notTaken.lock().get() == oldSucc) {
+        // fall-through can only reach the next block, make it explicit
+        from.instrs.push_back(std::make_shared<Jump>(newLabel));
+        from.taken = newSucc;
+        from.notTaken.reset();
+    }
+}
+
+void InsertBeforeTerminator(BasicBlock& bb, InstPtr instr) {
+    auto pos = bb.instrs.end();
+    if (!bb.instrs.empty() && bb.instrs.back()->isTerminator()) --pos;
+    bb.instrs.insert(pos, std::move(instr));
+}
+
+BBPtr GetOrInsertPreheader(Function& func, const Loop& loop) {
+    auto preds = Predecessors(func);
+    std::vector<BasicBlock*> outside;
+    for (auto* pred : preds[loop.header])
+        if (!loop.contains(pred)) outside.push_back(pred);
+    BBPtr header = FindBlock(func, loop.header);
+    bool isEntry = func.getEntry() == header;
+    if (!isEntry && outside.size() == 1 && outside.front()->successors().size() == 1)
+        return FindBlock(func, outside.front());
+
+    std::string headerLabel = EnsureLabel(func, *header);
+    auto preheader = std::make_shared<BasicBlock>();
+    preheader->instrs.push_back(std::make_shared<Label>(FreshLabel(func, headerLabel + ".preheader")));
+    preheader->notTaken = header;
+    auto pos = std::ranges::find(func.basicBlocks, header);
+    // a latch laid out right before the header must keep falling into the header
+    if (pos != func.basicBlocks.begin()) {
+        BasicBlock& layoutPred = **std::prev(pos);
+        bool fallsThrough = layoutPred.instrs.empty() || !layoutPred.instrs.back()->isTerminator();
+        if (fallsThrough && loop.contains(&layoutPred)) RedirectEdge(layoutPred, header.get(), header, headerLabel);
+    }
+    std::string preheaderLabel = std::dynamic_pointer_cast<Label>(preheader->instrs.front())->name;
+    for (auto* pred : outside) {
+        bool fallsThrough = pred->instrs.empty() || !pred->instrs.back()->isTerminator();
+        if (fallsThrough)
+            pred->notTaken = preheader;  // it is the layout predecessor, now falling into the preheader
+        else
+            RedirectEdge(*pred, header.get(), preheader, preheaderLabel);
+    }
+    func.basicBlocks.insert(pos, preheader);
+    if (isEntry) func.setEntry(preheader);
+    return preheader;
+}
+
+}  // namespace opt
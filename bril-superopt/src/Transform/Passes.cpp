@@ -0,0 +1,75 @@
+#include <IR/Function.h>
+#include <IR/Program.h>
+#include <Transform/BoundsCheck.h>
+#include <Transform/DCE.h>
+#include <Transform/DSE.h>
+#include <Transform/Inline.h>
+#include <Transform/LICM.h>
+#include <Transform/Passes.h>
+#include <Transform/SCCP.h>
+#include <Transform/ScalarRepl.h>
+#include <Transform/TailCall.h>
+
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using ProgramPass = std::function<bool(ir::Program&, const PassOptions&)>;
+
+ProgramPass ForEachFunction(bool (*pass)(ir::Function&)) {
+    return [pass](ir::Program& prog, [[maybe_unused]] const PassOptions& options) {
+        bool changed = false;
+        for (auto& func : prog.functions) changed |= pass(*func);
+        return changed;
+    };
+}
+
+const std::unordered_map<std::string, ProgramPass>& PassRegistry() {
+    static const std::unordered_map<std::string, ProgramPass> registry = {
+        {"sccp", ForEachFunction(SCCP)},
+        {"dce", ForEachFunction(DCE)},
+        {"dse", ForEachFunction(DSE)},
+        {"licm", ForEachFunction(LICM)},
+        {"tce", ForEachFunction(TailCallElim)},
+        {"bce", ForEachFunction(ElideBoundsChecks)},
+        {"sroa", [](ir::Program& prog, [[maybe_unused]] const PassOptions& options) {
+             bool changed = false;
+             for (auto& func : prog.functions) changed |= ScalarReplace(*func);
+             return changed;
+         }},
+        {"inline", [](ir::Program& prog, const PassOptions& options) {
+             InlineParams params;
+             params.useProfile = options.callProfile;
+             return Inline(prog, params);
+         }},
+    };
+    return registry;
+}
+
+}  // namespace
+
+void RunPasses(ir::Program& prog, const std::vector<std::string>& passes, const PassOptions& options) {
+    const auto& registry = PassRegistry();
+    for (const auto& name : passes) {
+        auto it = registry.find(name);
+        if (it == registry.end()) throw std::runtime_error("error: unknown pass: " + name);
+        it->second(prog, options);
+    }
+}
+
+std::vector<std::string> ParsePassList(const std::string& list) {
+    std::vector<std::string> passes;
+    std::stringstream ss(list);
+    for (std::string name; std::getline(ss, name, ',');)
+        if (!name.empty()) passes.push_back(name);
+    return passes;
+}
+
+}  // namespace opt
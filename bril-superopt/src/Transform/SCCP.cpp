@@ -0,0 +1,184 @@
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <Transform/SCCP.h>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+// a variable missing from ConstEnv is undefined (lattice top)
+struct LatticeVal {
+    bool isConst;  // false: overdefined
+    int64_t val;
+
+    bool operator==(const LatticeVal& other) const = default;
+};
+
+using ConstEnv = std::unordered_map<std::string, LatticeVal>;
+
+constexpr LatticeVal Overdefined{false, 0};
+
+std::optional<LatticeVal> Lookup(const ConstEnv& env, const std::string& name) {
+    if (auto it = env.find(name); it != env.end()) return it->second;
+    return std::nullopt;
+}
+
+// meet 'from' into 'into', true if 'into' moved down the lattice
+bool Meet(ConstEnv& into, const ConstEnv& from) {
+    bool changed = false;
+    for (const auto& [name, val] : from) {
+        auto [it, inserted] = into.try_emplace(name, val);
+        if (inserted) {
+            changed = true;
+        } else if (it->second.isConst && it->second != val) {
+            it->second = Overdefined;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// abstract value of the variable defined by 'instr', std::nullopt for undefined
+std::optional<LatticeVal> Evaluate(const InstPtr& instr, const ConstEnv& env) {
+    if (auto constant = std::dynamic_pointer_cast<Constant>(instr)) {
+        return LatticeVal{true, constant->val};
+    } else if (auto binOp = std::dynamic_pointer_cast<BinaryOp>(instr)) {
+        auto lhs = Lookup(env, binOp->lhs->name), rhs = Lookup(env, binOp->rhs->name);
+        if (!lhs || !rhs) return std::nullopt;
+        if (!lhs->isConst || !rhs->isConst) return Overdefined;
+        if (binOp->op == BinaryOpType::Div && rhs->val == 0) return Overdefined;  // keep the runtime error
+        return LatticeVal{true, EvalBinOp(binOp->op, lhs->val, rhs->val)};
+    } else if (auto unOp = std::dynamic_pointer_cast<UnaryOp>(instr)) {
+        auto src = Lookup(env, unOp->src->name);
+        if (!src || !src->isConst) return src;
+        return LatticeVal{true, EvalUnOp(unOp->op, src->val)};
+    } else if (auto id = std::dynamic_pointer_cast<Id>(instr)) {
+        return Lookup(env, id->src);
+    }
+    return Overdefined;  // call, load, alloc, ptradd
+}
+
+void Transfer(const InstPtr& instr, ConstEnv& env) {
+    for (const auto& def : instr->defs()) {
+        if (auto val = Evaluate(instr, env))
+            env[def] = *val;
+        else
+            env.erase(def);
+    }
+}
+
+// successors reachable from 'bb' given the environment at its end
+std::vector<BasicBlock*> ExecutableSuccessors(const BasicBlock& bb, const ConstEnv& env) {
+    std::vector<BasicBlock*> succs;
+    auto push = [&](const BBWPtr& succ) {
+        if (auto s = succ.lock()) succs.push_back(s.get());
+    };
+    if (bb.instrs.empty()) {
+        push(bb.notTaken);
+        return succs;
+    }
+    const auto& term = bb.instrs.back();
+    if (auto branch = std::dynamic_pointer_cast<Branch>(term)) {
+        auto cond = Lookup(env, branch->cond->name);
+        if (!cond || !cond->isConst || cond->val) push(bb.taken);
+        if (!cond || !cond->isConst || !cond->val) push(bb.notTaken);
+    } else if (std::dynamic_pointer_cast<Jump>(term)) {
+        push(bb.taken);
+    } else if (!std::dynamic_pointer_cast<Return>(term)) {
+        push(bb.notTaken);  // fall-through, null at the end of the function
+    }
+    return succs;
+}
+
+// replace 'instr' by a 'const' if it computes a known value
+bool FoldInstr(InstPtr& instr, const ConstEnv& env) {
+    VarPtr dest;
+    if (auto binOp = std::dynamic_pointer_cast<BinaryOp>(instr))
+        dest = binOp->dest;
+    else if (auto unOp = std::dynamic_pointer_cast<UnaryOp>(instr))
+        dest = unOp->dest;
+    else if (auto id = std::dynamic_pointer_cast<Id>(instr))
+        dest = id->dest;
+    else
+        return false;
+    auto val = Evaluate(instr, env);
+    if (!val || !val->isConst) return false;
+    instr = std::make_shared<Constant>(dest, val->val);
+    return true;
+}
+
+// replace a 'br' on a known condition by a 'jmp', updating the CFG edges in place
+bool FoldBranch(BasicBlock& bb, const ConstEnv& env) {
+    if (bb.instrs.empty()) return false;
+    auto branch = std::dynamic_pointer_cast<Branch>(bb.instrs.back());
+    if (!branch) return false;
+    auto cond = Lookup(env, branch->cond->name);
+    if (!cond || !cond->isConst) return false;
+    if (cond->val) {
+        bb.instrs.back() = std::make_shared<Jump>(branch->ifTrue);
+    } else {
+        bb.instrs.back() = std::make_shared<Jump>(branch->ifFalse);
+        bb.taken = bb.notTaken;
+    }
+    bb.notTaken.reset();
+    return true;
+}
+
+}  // namespace
+
+bool SCCP(Function& func) {
+    BBPtr entry = func.getEntry();
+    if (!entry) return false;
+
+    // propagate over executable edges until the block entry states settle
+    std::unordered_map<BasicBlock*, ConstEnv> inEnv;
+    for (const auto& arg : func.args) inEnv[entry.get()][arg->name] = Overdefined;
+    inEnv.try_emplace(entry.get());
+    std::deque<BasicBlock*> worklist{entry.get()};
+    std::unordered_set<BasicBlock*> queued{entry.get()};
+    while (!worklist.empty()) {
+        BasicBlock* bb = worklist.front();
+        worklist.pop_front();
+        queued.erase(bb);
+        ConstEnv env = inEnv[bb];
+        for (const auto& instr : bb->instrs) Transfer(instr, env);
+        for (BasicBlock* succ : ExecutableSuccessors(*bb, env)) {
+            bool firstVisit = !inEnv.contains(succ);
+            bool changed = Meet(inEnv[succ], env);
+            if ((firstVisit || changed) && queued.insert(succ).second) worklist.push_back(succ);
+        }
+    }
+
+    // rewrite the reachable blocks, replaying the transfer to get per-instruction states
+    bool changed = false;
+    for (const auto& bb : func.basicBlocks) {
+        auto it = inEnv.find(bb.get());
+        if (it == inEnv.end()) continue;
+        ConstEnv env = it->second;
+        for (auto& instr : bb->instrs) {
+            if (instr->isTerminator()) break;
+            changed |= FoldInstr(instr, env);
+            Transfer(instr, env);
+        }
+        changed |= FoldBranch(*bb, env);
+    }
+    // a reachable block never falls through into an unreachable one, so dropping
+    // the latter keeps the layout of the remaining blocks valid
+    changed |= std::erase_if(func.basicBlocks, [&](const BBPtr& bb) {
+                   return !inEnv.contains(bb.get());
+               }) > 0;
+    return changed;
+}
+
+}  // namespace opt
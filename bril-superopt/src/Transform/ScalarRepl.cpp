@@ -0,0 +1,200 @@
+#include <Analysis/CFG.h>
+#include <Analysis/PointsTo.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Type.h>
+#include <Transform/ScalarRepl.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+// constant ints and element offsets of pointers into the allocation, by
+// variable; a variable that is absent may hold anything
+using OffsetState = std::unordered_map<std::string, int64_t>;
+
+void Transfer(const Instruction& instr, const Alloc& alloc, OffsetState& state) {
+    auto assign = [&](const std::string& dest, std::optional<int64_t> val) {
+        if (val)
+            state[dest] = *val;
+        else
+            state.erase(dest);
+    };
+    auto lookup = [&](const std::string& var) -> std::optional<int64_t> {
+        auto it = state.find(var);
+        return it == state.end() ? std::nullopt : std::optional<int64_t>(it->second);
+    };
+    if (&instr == &alloc) {
+        assign(alloc.dest->name, 0);
+    } else if (auto c = dynamic_cast<const Constant*>(&instr)) {
+        assign(c->dest->name, c->val);
+    } else if (auto id = dynamic_cast<const Id*>(&instr)) {
+        assign(id->dest->name, lookup(id->src));
+    } else if (auto ptrAdd = dynamic_cast<const PtrAdd*>(&instr)) {
+        auto base = lookup(ptrAdd->ptr), delta = lookup(ptrAdd->offset);
+        assign(ptrAdd->dest->name, base && delta ? std::optional<int64_t>(*base + *delta) : std::nullopt);
+    } else {
+        for (const auto& def : instr.defs()) state.erase(def);
+    }
+}
+
+// Forward dataflow of OffsetState: the element accessed by every load, store
+// and free through a pointer into 'site', nullopt if some access is not a
+// constant in-bounds element or the pointer is used in any other way.
+std::optional<std::unordered_map<const Instruction*, int64_t>> ResolveAccesses(const Function& func, const PointsTo& pointsTo, int site, int64_t size) {
+    const Alloc& alloc = *pointsTo.sites[site];
+    auto intoSite = [&](const std::string& var) { return pointsTo.pointees(var).contains(site); };
+    // running the alloc again or freeing it ends what the pointers into it refer to
+    auto step = [&](const Instruction& instr, OffsetState& state) {
+        auto free = dynamic_cast<const Free*>(&instr);
+        if (&instr == &alloc || (free && intoSite(free->site)))
+            std::erase_if(state, [&](const auto& entry) { return intoSite(entry.first); });
+        Transfer(instr, alloc, state);
+    };
+    auto blocks = ReversePostOrder(func);
+    std::unordered_map<const BasicBlock*, OffsetState> in, out;
+    auto preds = Predecessors(func);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto* bb : blocks) {
+            std::optional<OffsetState> state;
+            if (bb == func.getEntry().get()) state.emplace();
+            for (auto* pred : preds[bb]) {
+                auto it = out.find(pred);
+                if (it == out.end()) continue;  // not reached yet: optimistic
+                if (!state) {
+                    state = it->second;
+                    continue;
+                }
+                std::erase_if(*state, [&](const auto& entry) {
+                    auto other = it->second.find(entry.first);
+                    return other == it->second.end() || other->second != entry.second;
+                });
+            }
+            if (!state) state.emplace();
+            in[bb] = *state;
+            for (const auto& instr : bb->instrs) step(*instr, *state);
+            if (auto it = out.find(bb); it == out.end() || it->second != *state) {
+                out[bb] = std::move(*state);
+                changed = true;
+            }
+        }
+    }
+
+    std::unordered_map<const Instruction*, int64_t> accesses;
+    for (const auto& bb : func.basicBlocks) {
+        auto reached = in.find(bb.get());
+        for (const auto& instr : bb->instrs) {
+            bool touches = false;
+            for (const auto& var : instr->uses()) touches |= intoSite(var);
+            for (const auto& var : instr->defs()) touches |= intoSite(var);
+            if (!touches) {  // it may still define the constant an offset is made of
+                if (reached != in.end()) step(*instr, reached->second);
+                continue;
+            }
+            if (reached == in.end()) return std::nullopt;  // unreachable code is left alone
+            for (const auto& def : instr->defs())  // pointers that may also point elsewhere stay
+                if (intoSite(def) && pointsTo.pointees(def).size() != 1) return std::nullopt;
+            auto& state = reached->second;
+            auto offset = [&](const std::string& ptr) -> std::optional<int64_t> {
+                auto it = state.find(ptr);
+                return it == state.end() ? std::nullopt : std::optional<int64_t>(it->second);
+            };
+            if (auto load = std::dynamic_pointer_cast<Load>(instr)) {
+                auto off = offset(load->ptr);
+                if (!off || *off < 0 || *off >= size) return std::nullopt;  // keep the run-time error
+                accesses[instr.get()] = *off;
+            } else if (auto store = std::dynamic_pointer_cast<Store>(instr)) {
+                auto off = offset(store->ptr);
+                if (intoSite(store->val) || !off || *off < 0 || *off >= size) return std::nullopt;
+                accesses[instr.get()] = *off;
+            } else if (auto free = std::dynamic_pointer_cast<Free>(instr)) {
+                if (offset(free->site) != 0) return std::nullopt;
+                accesses[instr.get()] = 0;
+            } else if (!std::dynamic_pointer_cast<Id>(instr) && !std::dynamic_pointer_cast<PtrAdd>(instr) && instr.get() != &alloc) {
+                return std::nullopt;  // printed, passed, returned or compared
+            }
+            step(*instr, state);
+        }
+    }
+    return accesses;
+}
+
+std::string FreshName(std::unordered_set<std::string>& names, const std::string& hint) {
+    std::string name = hint;
+    for (int i = 1; names.contains(name); i++) name = hint + "." + std::to_string(i);
+    names.insert(name);
+    return name;
+}
+
+}  // namespace
+
+bool ScalarReplace(Function& func, int64_t maxSize) {
+    PointsTo pointsTo(func);
+    std::unordered_set<std::string> names;
+    for (const auto& arg : func.args) names.insert(arg->name);
+    for (const auto& bb : func.basicBlocks)
+        for (const auto& instr : bb->instrs) {
+            for (const auto& name : instr->uses()) names.insert(name);
+            for (const auto& name : instr->defs()) names.insert(name);
+        }
+
+    bool changed = false;
+    for (int site = 0; site < static_cast<int>(pointsTo.sites.size()); site++) {
+        const auto& alloc = pointsTo.sites[site];
+        auto pointerType = std::dynamic_pointer_cast<PointerType>(alloc->dest->type);
+        // elements start as 'const 0' like heap words, which pointers cannot be
+        if (pointsTo.escapes(site) || !pointerType || std::dynamic_pointer_cast<PointerType>(pointerType->getPointee())) continue;
+        // the size must be a constant right at the alloc
+        std::optional<int64_t> size;
+        for (const auto& bb : func.basicBlocks) {
+            OffsetState state;
+            for (const auto& instr : bb->instrs) {
+                if (instr == alloc && state.contains(alloc->size)) size = state.at(alloc->size);
+                Transfer(*instr, *alloc, state);
+            }
+        }
+        if (!size || *size <= 0 || *size > maxSize) continue;
+        auto accesses = ResolveAccesses(func, pointsTo, site, *size);
+        if (!accesses) continue;
+
+        std::vector<VarPtr> elements;
+        for (int64_t i = 0; i < *size; i++)
+            elements.push_back(std::make_shared<Variable>(FreshName(names, alloc->dest->name + "." + std::to_string(i)), pointerType->getPointee()));
+        auto intoSite = [&](const std::string& var) { return pointsTo.pointees(var).contains(site); };
+        for (const auto& bb : func.basicBlocks) {
+            std::vector<InstPtr> instrs;
+            for (const auto& instr : bb->instrs) {
+                if (auto load = std::dynamic_pointer_cast<Load>(instr); load && accesses->contains(instr.get())) {
+                    instrs.push_back(std::make_shared<Id>(load->dest, elements[accesses->at(instr.get())]->name));
+                } else if (auto store = std::dynamic_pointer_cast<Store>(instr); store && accesses->contains(instr.get())) {
+                    instrs.push_back(std::make_shared<Id>(elements[accesses->at(instr.get())], store->val));
+                } else if (accesses->contains(instr.get())) {
+                    continue;  // free
+                } else if (instr == alloc) {
+                    for (const auto& element : elements) instrs.push_back(std::make_shared<Constant>(element, 0));
+                } else if (!instr->defs().empty() && intoSite(instr->defs().front())) {
+                    continue;  // pointers derived from the alloc
+                } else {
+                    instrs.push_back(instr);
+                }
+            }
+            bb->instrs = std::move(instrs);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+}  // namespace opt
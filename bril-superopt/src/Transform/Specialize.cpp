@@ -0,0 +1,267 @@
+#include <Analysis/CFG.h>
+#include <Analysis/Dominators.h>
+#include <Analysis/Loops.h>
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <IR/Program.h>
+#include <Transform/DCE.h>
+#include <Transform/Inline.h>
+#include <Transform/LoopUtils.h>
+#include <Transform/SCCP.h>
+#include <Transform/Specialize.h>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+size_t Size(const std::vector<BBPtr>& blocks) {
+    size_t size = 0;
+    for (const auto& bb : blocks)
+        for (const auto& instr : bb->instrs)
+            if (!std::dynamic_pointer_cast<Label>(instr)) size++;
+    return size;
+}
+
+// replace the known arguments of @main by constants defined in a new entry block
+void BindArguments(Function& main, const std::unordered_map<std::string, int64_t>& known) {
+    auto entry = std::make_shared<BasicBlock>();
+    entry->instrs.push_back(std::make_shared<Label>(FreshLabel(main, "specialized")));
+    std::vector<VarPtr> remaining;
+    for (const auto& arg : main.args) {
+        if (auto it = known.find(arg->name); it != known.end())
+            entry->instrs.push_back(std::make_shared<Constant>(arg, it->second));
+        else
+            remaining.push_back(arg);
+    }
+    for (const auto& [name, val] : known)
+        if (std::ranges::none_of(main.args, [&](const VarPtr& arg) { return arg->name == name; }))
+            throw std::runtime_error("error: @main has no argument named " + name);
+    main.args = std::move(remaining);
+    if (BBPtr oldEntry = main.getEntry()) {
+        entry->instrs.push_back(std::make_shared<Jump>(EnsureLabel(main, *oldEntry, "entry")));
+        entry->taken = oldEntry;
+    }
+    main.basicBlocks.insert(main.basicBlocks.begin(), entry);
+    main.setEntry(entry);
+}
+
+// Copy one iteration of 'loop' in front of it: the entry edge now reaches the
+// copy of the header, the copy's back edges the original header and its
+// exits the original exits. Returns the copied blocks, header first.
+std::vector<BBPtr> PeelIteration(Function& func, const Loop& loop) {
+    BBPtr preheader = GetOrInsertPreheader(func, loop);
+    BBPtr header = FindBlock(func, loop.header);
+    std::vector<BBPtr> blocks = {header};
+    for (const auto& bb : func.basicBlocks)
+        if (bb != header && loop.contains(bb.get())) blocks.push_back(bb);
+
+    // every target gets a label since the copies make all edges explicit
+    std::unordered_map<std::string, std::string> labelMap;
+    std::unordered_map<const BasicBlock*, std::string> labels;
+    for (const auto& bb : blocks) {
+        labels[bb.get()] = EnsureLabel(func, *bb);
+        for (const auto& succ : bb->successors()) labels[succ.get()] = EnsureLabel(func, *succ);
+    }
+    for (const auto& bb : blocks) {
+        if (bb == header) continue;
+        labelMap[labels.at(bb.get())] = FreshLabel(func, labels.at(bb.get()) + ".peel");
+    }
+    std::string headerCopyLabel = FreshLabel(func, labels.at(header.get()) + ".peel");
+    Renamer sameVar = [](const std::string& name) { return name; };
+    Renamer mapLabel = [&](const std::string& name) {
+        auto it = labelMap.find(name);
+        return it == labelMap.end() ? name : it->second;
+    };
+
+    std::unordered_map<const BasicBlock*, BBPtr> copies;
+    for (const auto& bb : blocks) copies[bb.get()] = std::make_shared<BasicBlock>();
+    auto target = [&](const BBPtr& succ) -> BBPtr {
+        if (succ == header || !loop.contains(succ.get())) return succ;
+        return copies.at(succ.get());
+    };
+    for (const auto& bb : blocks) {
+        BBPtr copy = copies.at(bb.get());
+        for (const auto& instr : bb->instrs) copy->instrs.push_back(instr->clone(sameVar, mapLabel));
+        if (bb == header) copy->instrs.front() = std::make_shared<Label>(headerCopyLabel);
+        if (auto taken = bb->taken.lock()) copy->taken = target(taken);
+        if (auto notTaken = bb->notTaken.lock()) {
+            if (!bb->instrs.back()->isTerminator()) {  // the copy is not laid out before the successor
+                BBPtr succ = target(notTaken);
+                std::string label = succ == notTaken ? labels.at(notTaken.get()) : mapLabel(labels.at(notTaken.get()));
+                copy->instrs.push_back(std::make_shared<Jump>(label));
+                copy->taken = succ;
+            } else
+                copy->notTaken = target(notTaken);
+        }
+    }
+
+    std::vector<BBPtr> peeled;
+    for (const auto& bb : blocks) peeled.push_back(copies.at(bb.get()));
+    // the preheader sits right before the header, the copies go in between
+    bool fallsThrough = preheader->instrs.empty() || !preheader->instrs.back()->isTerminator();
+    if (fallsThrough)
+        preheader->notTaken = peeled.front();
+    else
+        RedirectEdge(*preheader, header.get(), peeled.front(), headerCopyLabel);
+    auto pos = std::ranges::find(func.basicBlocks, header);
+    func.basicBlocks.insert(pos, peeled.begin(), peeled.end());
+    return peeled;
+}
+
+// some copied block still branches on whether to leave the loop
+bool HasOpenExit(const Function& func, const std::vector<BBPtr>& peeled, const BasicBlock* header) {
+    std::unordered_set<const BasicBlock*> inCopy;
+    for (const auto& bb : peeled) inCopy.insert(bb.get());
+    for (const auto& bb : func.basicBlocks) {
+        if (!inCopy.contains(bb.get()) || bb->instrs.empty() || !std::dynamic_pointer_cast<Branch>(bb->instrs.back())) continue;
+        auto succs = bb->successors();
+        auto inside = [&](const BBPtr& succ) { return inCopy.contains(succ.get()) || succ.get() == header; };
+        if (succs.size() == 2 && inside(succs[0]) != inside(succs[1])) return true;
+    }
+    return false;
+}
+
+// Merge every block into its predecessor when that is its only predecessor
+// and it is that predecessor's only successor: the jump chains left behind
+// by unrolling become straight-line code.
+void MergeBlocks(Function& func) {
+    for (bool changed = true; changed;) {
+        changed = false;
+        auto preds = Predecessors(func);
+        for (size_t i = 0; i < func.basicBlocks.size() && !changed; i++) {
+            BBPtr bb = func.basicBlocks[i];
+            auto succs = bb->successors();
+            if (succs.size() != 1 || succs.front() == bb || succs.front() == func.getEntry()) continue;
+            BBPtr succ = succs.front();
+            InstPtr term = bb->instrs.empty() ? nullptr : bb->instrs.back();
+            if (preds[succ.get()].size() != 1 || (term && term->isTerminator() && !std::dynamic_pointer_cast<Jump>(term))) continue;
+            auto pos = std::ranges::find(func.basicBlocks, succ);
+            // 'succ' leaves its place in the layout, so its own fall-through becomes a jump
+            bool succFallsThrough = succ->instrs.empty() || !succ->instrs.back()->isTerminator();
+            if (auto next = succ->notTaken.lock(); succFallsThrough && next && std::next(pos) != func.basicBlocks.end() && *std::next(pos) == next && pos != func.basicBlocks.begin() + i + 1)
+                RedirectEdge(*succ, next.get(), next, EnsureLabel(func, *next));
+            if (term && term->isTerminator()) bb->instrs.pop_back();
+            for (const auto& instr : succ->instrs)
+                if (!std::dynamic_pointer_cast<Label>(instr)) bb->instrs.push_back(instr);
+            bb->taken = succ->taken;
+            bb->notTaken = succ->notTaken;
+            func.basicBlocks.erase(pos);
+            changed = true;
+        }
+    }
+}
+
+void Simplify(Function& func) {
+    while (SCCP(func) | DCE(func)) {
+    }
+}
+
+// whether 'func' can reach itself through calls
+bool Recursive(const Function& func) {
+    std::unordered_set<const Function*> seen;
+    std::vector<const Function*> stack = {&func};
+    while (!stack.empty()) {
+        const Function* caller = stack.back();
+        stack.pop_back();
+        for (const auto& bb : caller->basicBlocks)
+            for (const auto& instr : bb->instrs) {
+                auto call = std::dynamic_pointer_cast<Call>(instr);
+                auto callee = call ? call->func.lock() : nullptr;
+                if (callee.get() == &func) return true;
+                if (callee && seen.insert(callee.get()).second) stack.push_back(callee.get());
+            }
+    }
+    return false;
+}
+
+// variables of 'func' that are only ever assigned constants
+std::unordered_set<std::string> ConstantVars(const Function& func) {
+    std::unordered_set<std::string> constant, other;
+    for (const auto& arg : func.args) other.insert(arg->name);
+    for (const auto& bb : func.basicBlocks)
+        for (const auto& instr : bb->instrs)
+            for (const auto& def : instr->defs()) (std::dynamic_pointer_cast<Constant>(instr) ? constant : other).insert(def);
+    std::erase_if(constant, [&](const std::string& name) { return other.contains(name); });
+    return constant;
+}
+
+// Inline the calls of 'func' that pass some constant (or no argument at all)
+// to a function outside any call cycle, so that its code sees them, until
+// none is left or the budget runs out. Returns the budget left.
+size_t InlineConstantCalls(Function& func, size_t budget) {
+    while (true) {
+        Simplify(func);
+        auto constant = ConstantVars(func);
+        bool changed = InlineCalls(func, [&](const Call& call, const Function& callee) {
+            size_t cost = Size(callee.basicBlocks);
+            if (cost > budget || Recursive(callee)) return false;
+            if (!call.args.empty() && std::ranges::none_of(call.args, [&](const std::string& arg) { return constant.contains(arg); })) return false;
+            budget -= cost;
+            return true;
+        });
+        if (!changed) return budget;
+    }
+}
+
+// fully unroll the loops of 'func' whose trip count folds to a constant
+void UnrollConstantLoops(Function& func, size_t budget) {
+    std::unordered_map<const BasicBlock*, BBPtr> givenUp;  // owned, so the address is not reused
+    while (true) {
+        DominatorTree domTree(func);
+        LoopInfo loops(func, domTree);
+        const Loop* candidate = nullptr;
+        for (const Loop* loop : loops.postOrder()) {
+            if (givenUp.contains(loop->header)) continue;
+            if (loop->exitBlocks().empty()) {  // only left through 'ret', if at all
+                givenUp[loop->header] = FindBlock(func, loop->header);
+                continue;
+            }
+            candidate = loop;
+            break;
+        }
+        if (!candidate) return;
+        std::vector<BBPtr> loopBlocks;
+        for (const auto& bb : func.basicBlocks)
+            if (candidate->contains(bb.get())) loopBlocks.push_back(bb);
+        size_t cost = Size(loopBlocks);
+        if (cost > budget) {
+            givenUp[candidate->header] = FindBlock(func, candidate->header);
+            continue;
+        }
+        budget -= cost;
+        BBPtr header = FindBlock(func, candidate->header);
+        auto peeled = PeelIteration(func, *candidate);
+        Simplify(func);
+        // the copy did not decide whether to leave: the trip count is unknown
+        if (HasOpenExit(func, peeled, header.get())) givenUp[header.get()] = header;
+    }
+}
+
+}  // namespace
+
+void Specialize(Program& prog, const std::unordered_map<std::string, int64_t>& known, const SpecializeParams& params) {
+    if (!prog.mainFunc) throw std::runtime_error("error: main function not found");
+    Function& main = *prog.mainFunc;
+    BindArguments(main, known);
+    size_t budget = params.unrollBudget;
+    if (params.inlineCalls) {
+        Inline(prog);
+        budget = InlineConstantCalls(main, budget);
+    }
+    for (auto& func : prog.functions) Simplify(*func);
+    UnrollConstantLoops(main, budget);
+    MergeBlocks(main);
+}
+
+}  // namespace opt
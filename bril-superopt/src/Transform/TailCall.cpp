@@ -0,0 +1,80 @@
+#include <IR/BasicBlock.h>
+#include <IR/Function.h>
+#include <IR/Instruction.h>
+#include <Transform/LoopUtils.h>
+#include <Transform/TailCall.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace opt {
+
+namespace {
+
+using namespace ir;
+
+// the self call ending 'bb' if its result is returned right away
+std::shared_ptr<Call> SelfTailCall(const Function& func, const BasicBlock& bb) {
+    size_t n = bb.instrs.size();
+    if (n < 2) return nullptr;
+    auto call = std::dynamic_pointer_cast<Call>(bb.instrs[n - 2]);
+    auto ret = std::dynamic_pointer_cast<Return>(bb.instrs[n - 1]);
+    if (!call || !ret || call->funcName != func.name) return nullptr;
+    bool returnsResult = ret->val ? call->dest && call->dest->name == *ret->val : !call->dest;
+    return returnsResult ? call : nullptr;
+}
+
+std::unordered_set<std::string> VarNames(const Function& func) {
+    std::unordered_set<std::string> names;
+    for (const auto& arg : func.args) names.insert(arg->name);
+    for (const auto& bb : func.basicBlocks)
+        for (const auto& instr : bb->instrs)
+            for (const auto& name : instr->defs()) names.insert(name);
+    return names;
+}
+
+}  // namespace
+
+bool TailCallElim(Function& func) {
+    BBPtr entry = func.getEntry();
+    if (!entry) return false;
+    std::unordered_set<std::string> params, names = VarNames(func);
+    for (const auto& arg : func.args) params.insert(arg->name);
+
+    bool changed = false;
+    std::string entryLabel;
+    for (const auto& bb : func.basicBlocks) {
+        auto call = SelfTailCall(func, *bb);
+        if (!call) continue;
+        if (entryLabel.empty()) entryLabel = EnsureLabel(func, *entry, "entry");
+        bb->instrs.resize(bb->instrs.size() - 2);
+        // parallel assignment: an argument naming another parameter is read
+        // into a temporary before any parameter is overwritten
+        std::vector<InstPtr> copies;
+        for (size_t i = 0; i < func.args.size(); i++) {
+            const VarPtr& param = func.args[i];
+            const std::string& arg = call->args[i];
+            if (arg == param->name) continue;
+            if (!params.contains(arg)) {
+                copies.push_back(std::make_shared<Id>(param, arg));
+                continue;
+            }
+            std::string tmp = param->name + ".tail";
+            for (int k = 1; names.contains(tmp); k++) tmp = param->name + ".tail." + std::to_string(k);
+            names.insert(tmp);
+            bb->instrs.push_back(std::make_shared<Id>(std::make_shared<Variable>(tmp, param->type), arg));
+            copies.push_back(std::make_shared<Id>(param, tmp));
+        }
+        bb->instrs.insert(bb->instrs.end(), copies.begin(), copies.end());
+        bb->instrs.push_back(std::make_shared<Jump>(entryLabel));
+        bb->taken = entry;
+        bb->notTaken.reset();
+        changed = true;
+    }
+    return changed;
+}
+
+}  // namespace opt
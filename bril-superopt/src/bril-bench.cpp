@@ -0,0 +1,294 @@
+#include <IR/DynCount.h>
+#include <IR/Heap.h>
+#include <IR/Parser.h>
+#include <IR/PerfCounters.h>
+#include <IR/Program.h>
+#include <Trace/Tracer.h>
+#include <Transform/Fuse.h>
+#include <Transform/Passes.h>
+#ifdef BRIL_HAVE_JIT
+#include <JIT/Jit.h>
+#include <JIT/Tiering.h>
+#endif
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using json = nlohmann::json;
+
+namespace {
+
+// swallows the programs' output
+class NullBuffer : public std::streambuf {
+   protected:
+    int overflow(int c) override { return c; }
+};
+
+struct Options {
+    std::vector<std::string> engines = {"interp"};
+    std::vector<std::string> passes;
+    size_t warmup = 2, runs = 10;
+    bool jsonOut = false;
+    bool perfCounters = false;
+};
+
+// One engine with its own copy of the program. Compiled code, recorded
+// traces and tiering counters persist across runs, so that the warmup runs
+// bring it to a steady state.
+struct Engine {
+    ir::ProgramPtr program;  // declared first: the engines below refer to it
+    std::unique_ptr<trace::TraceEngine> tracer;
+#ifdef BRIL_HAVE_JIT
+    std::unique_ptr<jit::JitEngine> jit;
+    std::unique_ptr<jit::TieredEngine> tiered;
+#endif
+
+    std::optional<int64_t> run(ir::varContext& vars, ir::HeapManager& heap) {
+        if (tracer) return tracer->run(vars, heap);
+#ifdef BRIL_HAVE_JIT
+        if (jit) return jit->run(vars, heap);
+        if (tiered) return tiered->run(vars, heap);
+#endif
+        return program->execute(vars, heap);
+    }
+};
+
+// the program as brili would run it, after the passes (bce among them if asked)
+ir::ProgramPtr Load(const std::string& source, const Options& options) {
+    std::istringstream input(source);
+    auto program = ir::parse(input);
+    opt::RunPasses(*program, options.passes);
+    return program;
+}
+
+std::unique_ptr<Engine> MakeEngine(const std::string& name, const std::string& source, const Options& options) {
+    auto engine = std::make_unique<Engine>();
+    engine->program = Load(source, options);
+    if (name == "interp") return engine;
+    if (name == "fuse") {
+        for (auto& func : engine->program->functions) opt::FuseInstructions(*func);
+        return engine;
+    }
+    if (name == "trace") {
+        engine->tracer = std::make_unique<trace::TraceEngine>(*engine->program);
+        return engine;
+    }
+#ifdef BRIL_HAVE_JIT
+    if (name == "jit") {
+        engine->jit = std::make_unique<jit::JitEngine>(*engine->program);
+        engine->jit->compileAll();
+        return engine;
+    }
+    if (name == "tiered") {
+        engine->tiered = std::make_unique<jit::TieredEngine>(*engine->program);
+        return engine;
+    }
+#endif
+    throw std::runtime_error("error: unknown engine: " + name);
+}
+
+ir::varContext Arguments(ir::Program& program, const std::vector<std::string>& args) {
+    std::vector<char*> argv = {const_cast<char*>("bril-bench")};
+    for (const auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+    return program.SetupVarContext(static_cast<int>(argv.size()), argv.data());
+}
+
+// the arguments in the "# ARGS:" line of the .bril file next to 'path', if any
+std::vector<std::string> ArgsNextTo(const std::filesystem::path& path) {
+    std::ifstream source(std::filesystem::path(path).replace_extension(".bril"));
+    for (std::string line; std::getline(source, line);) {
+        auto pos = line.find("ARGS:");
+        if (pos == std::string::npos) continue;
+        std::istringstream words(line.substr(pos + 5));
+        std::vector<std::string> args;
+        for (std::string word; words >> word;) args.push_back(word);
+        return args;
+    }
+    return {};
+}
+
+std::vector<std::string> Split(const std::string& list, char sep) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    for (std::string item; std::getline(ss, item, sep);)
+        if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+// median of 'values', which it reorders
+double Median(std::vector<double> values) {
+    std::ranges::sort(values);
+    size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+// median absolute deviation from the median
+double Mad(const std::vector<double>& values, double median) {
+    std::vector<double> deviations;
+    for (double value : values) deviations.push_back(std::abs(value - median));
+    return Median(std::move(deviations));
+}
+
+struct Result {
+    std::string bench, engine;
+    uint64_t dynInst;
+    std::vector<double> times;  // ns per run
+    std::map<std::string, std::vector<double>> counters;  // per run, for the supported events
+};
+
+// instructions executed by one run, from the counting interpreter
+uint64_t CountInstructions(const std::string& source, const std::vector<std::string>& args, const Options& options) {
+    auto program = Load(source, options);
+    for (auto& func : program->functions) func->counting = true;
+    auto vars = Arguments(*program, args);
+    ir::HeapManager heap;
+    program->execute(vars, heap);
+    return ir::DynCount(*program).total;
+}
+
+std::vector<Result> Bench(const std::string& bench, const std::string& source, const std::vector<std::string>& args, const Options& options,
+                          ir::PerfCounters* counters) {
+    std::vector<Result> results;
+    uint64_t dynInst = CountInstructions(source, args, options);
+    for (const auto& name : options.engines) {
+        auto engine = MakeEngine(name, source, options);
+        Result result{bench, name, dynInst, {}, {}};
+        for (size_t i = 0; i < options.warmup + options.runs; i++) {
+            // fresh arguments and heap for every run, set up outside the timed part
+            auto vars = Arguments(*engine->program, args);
+            ir::HeapManager heap;
+            if (counters) counters->start();
+            auto start = std::chrono::steady_clock::now();
+            engine->run(vars, heap);
+            auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if (counters) counters->stop();
+            if (i < options.warmup) continue;
+            result.times.push_back(ns);
+            if (counters)
+                for (const auto& [event, value] : counters->read())
+                    if (value) result.counters[event].push_back(static_cast<double>(*value));
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+// 'events' adds a column of medians per event, empty where unsupported
+void WriteCsv(const std::vector<Result>& results, const std::vector<std::string>& events, std::ostream& os) {
+    os << "bench,engine,runs,median_ns,mad_ns,dyn_inst,ns_per_inst";
+    for (const auto& event : events) os << "," << event;
+    os << "\n";
+    for (const auto& res : results) {
+        double median = Median(res.times);
+        os << std::format("{},{},{},{:.0f},{:.0f},{},{:.3f}", res.bench, res.engine, res.times.size(), median, Mad(res.times, median), res.dynInst,
+                          res.dynInst ? median / res.dynInst : 0.0);
+        for (const auto& event : events) {
+            auto samples = res.counters.find(event);
+            os << (samples == res.counters.end() ? std::string(",") : std::format(",{:.0f}", Median(samples->second)));
+        }
+        os << "\n";
+    }
+}
+
+// {"results": [{"bench", "engine", "median_ns", "mad_ns", "dyn_inst", "ns_per_inst", "times_ns": [...],
+//               "counters": {"<event>": <median>, ...}}]}, counters only with --perf-counters
+void WriteJson(const std::vector<Result>& results, std::ostream& os) {
+    json out = json::array();
+    for (const auto& res : results) {
+        double median = Median(res.times);
+        out.push_back({{"bench", res.bench},
+                       {"engine", res.engine},
+                       {"median_ns", median},
+                       {"mad_ns", Mad(res.times, median)},
+                       {"dyn_inst", res.dynInst},
+                       {"ns_per_inst", res.dynInst ? median / res.dynInst : 0.0},
+                       {"times_ns", res.times}});
+        if (res.counters.empty()) continue;
+        json counters = json::object();
+        for (const auto& [event, samples] : res.counters) counters[event] = Median(samples);
+        out.back()["counters"] = counters;
+    }
+    os << json{{"results", out}}.dump(2) << std::endl;
+}
+
+}  // namespace
+
+// usage: bril-bench [--engines=interp,fuse,trace,jit,tiered] [--passes=<p>,...]
+//                   [--warmup=N] [--runs=N] [--json] [--perf-counters] [--args="<a> ..."] prog.json ...
+// Each program is loaded once per engine and run warmup + runs times in this
+// process; only the runs are timed. Arguments come from --args, which applies
+// to the programs after it, or else from the "# ARGS:" line of the .bril file
+// next to the JSON. Program output is discarded. --perf-counters adds the
+// medians of the hardware counters of the timed runs (see ir::PerfCounters).
+int main(int argc, char** argv) {
+    Options options;
+    std::optional<std::vector<std::string>> args;
+    std::vector<std::pair<std::string, std::optional<std::vector<std::string>>>> programs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--engines="))
+            options.engines = Split(arg.substr(std::string("--engines=").size()), ',');
+        else if (arg.starts_with("--passes="))
+            options.passes = opt::ParsePassList(arg.substr(std::string("--passes=").size()));
+        else if (arg.starts_with("--warmup="))
+            options.warmup = std::stoull(arg.substr(std::string("--warmup=").size()));
+        else if (arg.starts_with("--runs="))
+            options.runs = std::stoull(arg.substr(std::string("--runs=").size()));
+        else if (arg == "--json")
+            options.jsonOut = true;
+        else if (arg == "--perf-counters")
+            options.perfCounters = true;
+        else if (arg.starts_with("--args="))
+            args = Split(arg.substr(std::string("--args=").size()), ' ');
+        else
+            programs.emplace_back(arg, args);
+    }
+    if (options.runs == 0) throw std::runtime_error("error: --runs must be at least 1");
+
+    std::optional<ir::PerfCounters> counters;
+    std::vector<std::string> events;
+    if (options.perfCounters) {
+        counters.emplace();
+        for (const auto& [event, value] : counters->read()) events.push_back(event);
+    }
+
+    std::vector<Result> results;
+    for (const auto& [path, given] : programs) {
+        std::ifstream file(path);
+        if (!file) throw std::runtime_error("error: cannot read " + path);
+        std::stringstream source;
+        source << file.rdbuf();
+        // keep the programs' output out of the report
+        NullBuffer discard;
+        auto* saved = std::cout.rdbuf(&discard);
+        try {
+            auto res = Bench(std::filesystem::path(path).stem().string(), source.str(), given ? *given : ArgsNextTo(path), options,
+                             counters ? &*counters : nullptr);
+            std::ranges::move(res, std::back_inserter(results));
+        } catch (...) {
+            std::cout.rdbuf(saved);
+            throw;
+        }
+        std::cout.rdbuf(saved);
+    }
+    if (options.jsonOut)
+        WriteJson(results, std::cout);
+    else
+        WriteCsv(results, events, std::cout);
+    return 0;
+}
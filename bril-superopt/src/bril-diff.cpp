@@ -0,0 +1,351 @@
+#include <IR/Heap.h>
+#include <IR/Instruction.h>
+#include <IR/Parser.h>
+#include <IR/Program.h>
+#include <Trace/Tracer.h>
+#include <Transform/BoundsCheck.h>
+#include <Transform/Fuse.h>
+#include <Transform/Passes.h>
+#ifdef BRIL_HAVE_JIT
+#include <JIT/Jit.h>
+#include <JIT/Tiering.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Options {
+#ifdef BRIL_HAVE_JIT
+    std::vector<std::string> engines = {"interp", "fuse", "trace", "opt", "jit", "tiered"};
+#else
+    std::vector<std::string> engines = {"interp", "fuse", "trace", "opt"};
+#endif
+    std::vector<std::string> passes = {"inline", "sroa", "sccp", "licm", "dce", "dse", "tce"};
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+// One engine with its own copy of the program, which it keeps across runs:
+// traces, compiled code and tiering counters warm up as the inputs go by.
+struct Engine {
+    std::string name;
+    ir::ProgramPtr program;  // declared first: the engines below refer to it
+    std::unique_ptr<trace::TraceEngine> tracer;
+#ifdef BRIL_HAVE_JIT
+    std::unique_ptr<jit::JitEngine> jit;
+    std::unique_ptr<jit::TieredEngine> tiered;
+#endif
+
+    std::optional<int64_t> run(ir::varContext& vars, ir::HeapManager& heap) {
+        if (tracer) return tracer->run(vars, heap);
+#ifdef BRIL_HAVE_JIT
+        if (jit) return jit->run(vars, heap);
+        if (tiered) return tiered->run(vars, heap);
+#endif
+        return program->execute(vars, heap);
+    }
+};
+
+// "interp" is the reference: the program as written, every access bounds
+// checked. "opt" interprets it after the passes; the others run it as
+// 'brili --passes=bce' does, with the bounds checks it proves redundant elided.
+std::unique_ptr<Engine> MakeEngine(const std::string& name, const std::string& source, const Options& options) {
+    auto engine = std::make_unique<Engine>();
+    engine->name = name;
+    std::istringstream input(source);
+    engine->program = ir::parse(input);
+    if (name == "interp") return engine;
+    if (name == "opt") opt::RunPasses(*engine->program, options.passes);
+    for (auto& func : engine->program->functions) opt::ElideBoundsChecks(*func);
+    if (name == "opt") return engine;
+    if (name == "fuse") {
+        for (auto& func : engine->program->functions) opt::FuseInstructions(*func);
+        return engine;
+    }
+    if (name == "trace") {
+        engine->tracer = std::make_unique<trace::TraceEngine>(*engine->program);
+        return engine;
+    }
+#ifdef BRIL_HAVE_JIT
+    if (name == "jit") {
+        engine->jit = std::make_unique<jit::JitEngine>(*engine->program);
+        engine->jit->compileAll();
+        return engine;
+    }
+    if (name == "tiered") {
+        engine->tiered = std::make_unique<jit::TieredEngine>(*engine->program);
+        return engine;
+    }
+#endif
+    throw std::runtime_error("error: unknown engine: " + name);
+}
+
+// what one run printed, what @main returned and the error it stopped with
+struct Outcome {
+    std::string output;
+    std::optional<int64_t> ret;
+    std::optional<std::string> error;
+
+    bool operator==(const Outcome& other) const = default;
+};
+
+std::string Describe(const Outcome& outcome) {
+    std::string output;
+    for (char c : outcome.output) output += c == '\n' ? std::string("\\n") : std::string(1, c);
+    return std::format("output=\"{}\" ret={} error={}", output, outcome.ret ? std::to_string(*outcome.ret) : "none",
+                       outcome.error ? *outcome.error : "none");
+}
+
+// 'message' without the addresses in it, which differ between program copies
+std::string WithoutAddresses(const std::string& message) {
+    std::string result;
+    for (size_t i = 0; i < message.size(); i++) {
+        result += message[i];
+        if (message.compare(i, 2, "0x") != 0) continue;
+        result += "x...";
+        for (i += 2; i < message.size() && std::isxdigit(static_cast<unsigned char>(message[i])); i++);
+        i--;
+    }
+    return result;
+}
+
+// 'out' is where print writes on this thread
+Outcome Run(Engine& engine, const std::vector<std::string>& args, std::ostringstream& out) {
+    Outcome outcome;
+    out.str("");
+    try {
+        std::vector<char*> argv = {const_cast<char*>("bril-diff")};
+        for (const auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+        auto vars = engine.program->SetupVarContext(static_cast<int>(argv.size()), argv.data());
+        ir::HeapManager heap;
+        outcome.ret = engine.run(vars, heap);
+    } catch (const std::exception& e) {
+        outcome.error = WithoutAddresses(e.what());
+    }
+    outcome.output = out.str();
+    return outcome;
+}
+
+struct Divergence {
+    size_t input;
+    std::string reference, engine;
+    Outcome expected, actual;
+};
+
+// Workers take the inputs in chunks, in order, and run each one on every
+// engine. The first divergence found stops them from starting later inputs,
+// but an earlier one may still turn up in a chunk already taken.
+class Runner {
+   public:
+    uint64_t runs = 0;
+
+    Runner(std::string source, const Options& options, const std::vector<std::vector<std::string>>& inputs)
+        : source(std::move(source)), options(options), inputs(inputs) {}
+
+    std::optional<Divergence> run() {
+        // a second thread makes every shared_ptr copy atomic, so one runs here
+        if (options.threads == 1) {
+            work();
+            return divergence;
+        }
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(options.threads);
+        for (size_t i = 0; i < options.threads; i++)
+            workers.emplace_back([this, &errors, i] {
+                try {
+                    work();
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        for (auto& worker : workers) worker.join();
+        for (auto& error : errors)
+            if (error) std::rethrow_exception(error);
+        return divergence;
+    }
+
+   private:
+    static constexpr size_t Chunk = 16;
+
+    const std::string source;
+    const Options& options;
+    const std::vector<std::vector<std::string>>& inputs;
+    std::atomic<size_t> next = 0;
+    std::atomic<size_t> firstDivergent = std::numeric_limits<size_t>::max();
+    std::mutex lock;  // guards 'divergence' and 'runs'
+    std::optional<Divergence> divergence;
+
+    void work() {
+        std::vector<std::unique_ptr<Engine>> engines;
+        for (const auto& name : options.engines) engines.push_back(MakeEngine(name, source, options));
+        std::ostringstream out;
+        ir::SetOutput(&out);
+        uint64_t done = 0;
+        for (size_t start; (start = next.fetch_add(Chunk)) < inputs.size();) {
+            for (size_t i = start; i < std::min(start + Chunk, inputs.size()) && i < firstDivergent; i++) {
+                Outcome expected = Run(*engines.front(), inputs[i], out);
+                done++;
+                for (size_t e = 1; e < engines.size(); e++) {
+                    Outcome actual = Run(*engines[e], inputs[i], out);
+                    done++;
+                    if (actual == expected) continue;
+                    found({i, engines.front()->name, engines[e]->name, expected, std::move(actual)});
+                    break;
+                }
+            }
+        }
+        ir::SetOutput(nullptr);
+        std::lock_guard guard(lock);
+        runs += done;
+    }
+
+    void found(Divergence diverged) {
+        std::lock_guard guard(lock);
+        if (divergence && divergence->input <= diverged.input) return;
+        firstDivergent = diverged.input;
+        divergence = std::move(diverged);
+    }
+};
+
+std::vector<std::string> Split(const std::string& list, char sep) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    for (std::string item; std::getline(ss, item, sep);)
+        if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+// one argument vector per non-empty line
+std::vector<std::vector<std::string>> ReadInputs(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("error: cannot read " + path);
+    std::vector<std::vector<std::string>> inputs;
+    for (std::string line; std::getline(file, line);)
+        if (line.find_first_not_of(" \t") != std::string::npos) {
+            std::istringstream words(line);
+            inputs.emplace_back();
+            for (std::string word; words >> word;) inputs.back().push_back(word);
+        }
+    return inputs;
+}
+
+// 'count' argument vectors for @main: ints uniform in [lo, hi], bools fair coins
+std::vector<std::vector<std::string>> RandomInputs(const ir::Program& prog, size_t count, uint64_t seed, int64_t lo, int64_t hi) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::vector<std::string>> inputs(count);
+    for (auto& args : inputs)
+        for (const auto& arg : prog.mainFunc->args)
+            if (std::dynamic_pointer_cast<ir::BoolType>(arg->type))
+                args.push_back(rng() % 2 ? "true" : "false");
+            else
+                args.push_back(std::to_string(std::uniform_int_distribution<int64_t>(lo, hi)(rng)));
+    return inputs;
+}
+
+// the arguments in the "# ARGS:" line of the .bril file next to 'path', if any
+std::vector<std::string> ArgsNextTo(const std::filesystem::path& path) {
+    std::ifstream source(std::filesystem::path(path).replace_extension(".bril"));
+    for (std::string line; std::getline(source, line);) {
+        auto pos = line.find("ARGS:");
+        if (pos == std::string::npos) continue;
+        std::istringstream words(line.substr(pos + 5));
+        std::vector<std::string> args;
+        for (std::string word; words >> word;) args.push_back(word);
+        return args;
+    }
+    return {};
+}
+
+}  // namespace
+
+// usage: bril-diff [--engines=interp,fuse,trace,opt,jit,tiered] [--passes=<p>,...] [--threads=N]
+//                  [--inputs=FILE | --random=N [--seed=N] [--range=LO:HI]] prog.json
+// Loads the program once per engine and thread, runs every input (one
+// argument vector per line of FILE, N random ones, or else the "# ARGS:" line
+// of the .bril file next to the JSON) on each engine and compares what it
+// prints, returns and fails with against the first engine. Prints the first
+// divergence in input order and exits with 1, or 0 if there is none.
+int main(int argc, char** argv) {
+    Options options;
+    std::optional<std::string> path, inputsPath;
+    size_t random = 0;
+    uint64_t seed = 1;
+    int64_t lo = -100, hi = 100;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--engines="))
+            options.engines = Split(arg.substr(std::string("--engines=").size()), ',');
+        else if (arg.starts_with("--passes="))
+            options.passes = opt::ParsePassList(arg.substr(std::string("--passes=").size()));
+        else if (arg.starts_with("--threads="))
+            options.threads = std::stoull(arg.substr(std::string("--threads=").size()));
+        else if (arg.starts_with("--inputs="))
+            inputsPath = arg.substr(std::string("--inputs=").size());
+        else if (arg.starts_with("--random="))
+            random = std::stoull(arg.substr(std::string("--random=").size()));
+        else if (arg.starts_with("--seed="))
+            seed = std::stoull(arg.substr(std::string("--seed=").size()));
+        else if (arg.starts_with("--range=")) {
+            auto range = arg.substr(std::string("--range=").size());
+            auto colon = range.find(':', 1);
+            if (colon == std::string::npos) throw std::runtime_error("error: --range needs LO:HI");
+            lo = std::stoll(range.substr(0, colon));
+            hi = std::stoll(range.substr(colon + 1));
+        } else if (!path)
+            path = arg;
+        else
+            throw std::runtime_error("error: unexpected argument: " + arg);
+    }
+    if (!path) throw std::runtime_error("error: no program given");
+    if (options.engines.size() < 2) throw std::runtime_error("error: need at least two engines to compare");
+    if (options.threads == 0) throw std::runtime_error("error: --threads must be at least 1");
+    if (lo > hi) throw std::runtime_error("error: empty --range");
+
+    std::ifstream file(*path);
+    if (!file) throw std::runtime_error("error: cannot read " + *path);
+    std::stringstream source;
+    source << file.rdbuf();
+    std::vector<std::vector<std::string>> inputs;
+    if (inputsPath)
+        inputs = ReadInputs(*inputsPath);
+    else if (random) {
+        std::istringstream input(source.str());
+        inputs = RandomInputs(*ir::parse(input), random, seed, lo, hi);
+    } else
+        inputs = {ArgsNextTo(*path)};
+
+    Runner runner(source.str(), options, inputs);
+    auto start = std::chrono::steady_clock::now();
+    auto divergence = runner.run();
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << std::format("{} inputs, {} engines, {} threads: {} runs in {:.3f} s ({:.0f} runs/s)\n", inputs.size(),
+                             options.engines.size(), options.threads, runner.runs, seconds, runner.runs / seconds);
+    if (!divergence) {
+        std::cout << "no divergence" << std::endl;
+        return 0;
+    }
+    std::string args;
+    for (const auto& arg : inputs[divergence->input]) args += " " + arg;
+    std::cout << std::format("divergence on input {}:{}\n  {}: {}\n  {}: {}\n", divergence->input, args, divergence->reference,
+                             Describe(divergence->expected), divergence->engine, Describe(divergence->actual));
+    return 1;
+}
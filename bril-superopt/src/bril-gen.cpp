@@ -0,0 +1,212 @@
+#include <IR/Program.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using json = nlohmann::json;
+
+namespace {
+
+struct GenParams {
+    size_t functions = 4;   // @main and @f1 .. @f<n-1>
+    size_t blocks = 8;      // per function
+    size_t instrs = 8;      // per block, besides the terminator
+    size_t vars = 8;        // int variables per function
+    size_t depth = 2;       // longest chain of calls below @main
+    double memRatio = 0.1;  // share of loads and stores among the instructions
+    double callRatio = 0.02;
+    int64_t trip = 4;       // times each back edge may be taken per activation
+    uint64_t seed = 1;
+};
+
+// Slots of the array each function works on with memory ops enabled; its
+// offsets are constants, so every access is in bounds.
+constexpr int64_t MemSlots = 8;
+const json IntPtr = {{"ptr", "int"}};
+
+// Random but valid and terminating programs. Every variable is defined in
+// the entry block, so any later use is defined on every path. Control flow
+// only goes forward, except for loops closed by a back edge that is guarded
+// by its own counter: it is taken at most 'trip' times per activation, even
+// when an enclosing loop enters it again. Functions sit on call-graph levels
+// 1 .. depth and only call the level below, so recursion is impossible.
+class Generator {
+   public:
+    Generator(const GenParams& params) : params(params), rng(params.seed) {}
+
+    json program() {
+        json funcs = json::array();
+        for (size_t i = 0; i < params.functions; i++) funcs.push_back(function(i));
+        return json{{"functions", funcs}};
+    }
+
+   private:
+    GenParams params;
+    std::mt19937_64 rng;
+    json instrs;
+
+    size_t level(size_t func) const { return func == 0 ? 0 : 1 + (func - 1) % params.depth; }
+
+    size_t uniform(size_t lo, size_t hi) { return std::uniform_int_distribution<size_t>(lo, hi)(rng); }
+    bool chance(double p) { return std::uniform_real_distribution<double>(0, 1)(rng) < p; }
+    std::string var() { return "v" + std::to_string(uniform(0, params.vars - 1)); }
+
+    void emit(json instr) { instrs.push_back(std::move(instr)); }
+    void constant(const std::string& dest, const std::string& type, int64_t value) {
+        emit({{"op", "const"}, {"dest", dest}, {"type", type}, {"value", value}});
+    }
+    void op(const std::string& op, const std::string& dest, const json& type, std::vector<std::string> args) {
+        emit({{"op", op}, {"dest", dest}, {"type", type}, {"args", args}});
+    }
+    std::string label(size_t bb) const { return "b" + std::to_string(bb); }
+
+    json function(size_t index) {
+        std::vector<size_t> callees;
+        if (params.depth)
+            for (size_t i = 1; i < params.functions; i++)
+                if (level(i) == level(index) + 1) callees.push_back(i);
+        bool memory = params.memRatio > 0;
+        // blocks closing a loop, and the header each one jumps back to
+        std::vector<std::optional<size_t>> header(params.blocks);
+        for (size_t bb = 1; bb + 1 < params.blocks; bb++)
+            if (chance(0.25)) header[bb] = uniform(bb > 4 ? bb - 4 : 1, bb);
+
+        instrs = json::array();
+        emit({{"label", label(0)}});
+        for (size_t v = 0; v < params.vars; v++)
+            if (index && v == 0)
+                op("id", "v0", "int", {"a"});
+            else
+                constant("v" + std::to_string(v), "int", static_cast<int64_t>(v) + 1);
+        constant("one", "int", 1);
+        constant("three", "int", 3);
+        constant("trip", "int", params.trip);
+        for (size_t bb = 0; bb < params.blocks; bb++)
+            if (header[bb]) constant("c" + std::to_string(bb), "int", 0);
+        if (memory) {
+            constant("size", "int", MemSlots);
+            op("alloc", "mem", IntPtr, {"size"});
+            for (int64_t k = 0; k < MemSlots; k++) {
+                constant("k" + std::to_string(k), "int", k);
+                op("ptradd", "p", IntPtr, {"mem", "k" + std::to_string(k)});
+                emit({{"op", "store"}, {"args", {"p", "v0"}}});
+            }
+        }
+
+        for (size_t bb = 0; bb < params.blocks; bb++) {
+            if (bb) emit({{"label", label(bb)}});
+            for (size_t i = 0; i < params.instrs; i++) body(memory, callees);
+            terminator(bb, header[bb]);
+        }
+        // fold every variable into the result so that none is trivially dead
+        op("id", "sum", "int", {"v0"});
+        for (size_t v = 1; v < params.vars; v++) op("add", "sum", "int", {"sum", "v" + std::to_string(v)});
+        if (memory) emit({{"op", "free"}, {"args", {"mem"}}});
+
+        json func = {{"name", index ? "f" + std::to_string(index) : "main"}};
+        if (index) {
+            emit({{"op", "ret"}, {"args", {"sum"}}});
+            func["args"] = json::array({{{"name", "a"}, {"type", "int"}}});
+            func["type"] = "int";
+        } else
+            emit({{"op", "print"}, {"args", {"sum"}}});
+        func["instrs"] = std::move(instrs);
+        return func;
+    }
+
+    void body(bool memory, const std::vector<size_t>& callees) {
+        if (memory && chance(params.memRatio)) {
+            op("ptradd", "p", IntPtr, {"mem", "k" + std::to_string(uniform(0, MemSlots - 1))});
+            if (chance(0.5))
+                op("load", var(), "int", {"p"});
+            else
+                emit({{"op", "store"}, {"args", {"p", var()}}});
+            return;
+        }
+        if (!callees.empty() && chance(params.callRatio)) {
+            std::string callee = "f" + std::to_string(callees[uniform(0, callees.size() - 1)]);
+            emit({{"op", "call"}, {"dest", var()}, {"type", "int"}, {"funcs", {callee}}, {"args", {var()}}});
+            return;
+        }
+        switch (uniform(0, 3)) {
+            case 0: op("add", var(), "int", {var(), var()}); break;
+            case 1: op("sub", var(), "int", {var(), var()}); break;
+            case 2: op("mul", var(), "int", {var(), var()}); break;
+            default: op("div", var(), "int", {var(), "three"}); break;
+        }
+    }
+
+    void terminator(size_t bb, std::optional<size_t> header) {
+        if (bb + 1 == params.blocks) return;  // falls into the epilogue
+        std::string cond = "t" + std::to_string(bb);
+        if (header) {
+            std::string counter = "c" + std::to_string(bb);
+            op("add", counter, "int", {counter, "one"});
+            op("lt", cond, "bool", {counter, "trip"});
+            emit({{"op", "br"}, {"args", {cond}}, {"labels", {label(*header), label(bb + 1)}}});
+            return;
+        }
+        size_t last = std::min(params.blocks - 1, bb + 3);
+        switch (uniform(0, 2)) {
+            case 0: emit({{"op", "jmp"}, {"labels", {label(uniform(bb + 1, last))}}}); break;
+            case 1:
+                op("lt", cond, "bool", {var(), var()});
+                emit({{"op", "br"}, {"args", {cond}}, {"labels", {label(uniform(bb + 1, last)), label(uniform(bb + 1, last))}}});
+                break;
+            default: break;  // fall through
+        }
+    }
+};
+
+}  // namespace
+
+// usage: bril-gen [--functions=N] [--blocks=N] [--instrs=N] [--vars=N] [--depth=N]
+//                 [--mem=RATIO] [--calls=RATIO] [--trip=N] [--seed=N] [--text] > prog.json
+// The dynamic work of a run grows with 'trip' and with 'depth'; the static
+// size is functions * blocks * instrs.
+int main(int argc, char** argv) {
+    GenParams params;
+    bool text = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](const std::string& flag) { return arg.substr(flag.size()); };
+        if (arg.starts_with("--functions="))
+            params.functions = std::stoull(value("--functions="));
+        else if (arg.starts_with("--blocks="))
+            params.blocks = std::stoull(value("--blocks="));
+        else if (arg.starts_with("--instrs="))
+            params.instrs = std::stoull(value("--instrs="));
+        else if (arg.starts_with("--vars="))
+            params.vars = std::stoull(value("--vars="));
+        else if (arg.starts_with("--depth="))
+            params.depth = std::stoull(value("--depth="));
+        else if (arg.starts_with("--mem="))
+            params.memRatio = std::stod(value("--mem="));
+        else if (arg.starts_with("--calls="))
+            params.callRatio = std::stod(value("--calls="));
+        else if (arg.starts_with("--trip="))
+            params.trip = std::stoll(value("--trip="));
+        else if (arg.starts_with("--seed="))
+            params.seed = std::stoull(value("--seed="));
+        else if (arg == "--text")
+            text = true;
+        else
+            throw std::runtime_error("error: unknown option: " + arg);
+    }
+    if (params.functions == 0 || params.blocks == 0 || params.vars == 0)
+        throw std::runtime_error("error: --functions, --blocks and --vars must be at least 1");
+
+    json prog = Generator(params).program();
+    if (text)
+        std::cout << ir::Program(prog) << std::endl;
+    else
+        std::cout << prog.dump() << std::endl;
+    return 0;
+}
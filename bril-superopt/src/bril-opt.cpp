@@ -0,0 +1,72 @@
+#include <Analysis/Profile.h>
+#include <IR/Function.h>
+#include <IR/Parser.h>
+#include <IR/Type.h>
+#include <Transform/Passes.h>
+#include <Transform/Specialize.h>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+// "n=10,flag=true" into values of the @main arguments, checked against their types
+static std::unordered_map<std::string, int64_t> ParseKnownArgs(const std::string& list, const ir::Program& prog) {
+    if (!prog.mainFunc) throw std::runtime_error("error: main function not found");
+    std::unordered_map<std::string, int64_t> known;
+    std::stringstream ss(list);
+    for (std::string item; std::getline(ss, item, ',');) {
+        auto eq = item.find('=');
+        if (eq == std::string::npos) throw std::runtime_error("error: expected name=value: " + item);
+        std::string name = item.substr(0, eq), val = item.substr(eq + 1);
+        auto arg = std::ranges::find_if(prog.mainFunc->args, [&](const ir::VarPtr& arg) { return arg->name == name; });
+        if (arg == prog.mainFunc->args.end()) throw std::runtime_error("error: @main has no argument named " + name);
+        if (std::dynamic_pointer_cast<ir::BoolType>((*arg)->type)) {
+            if (val != "true" && val != "false") throw std::runtime_error("error: invalid argument type, should be bool: " + item);
+            known[name] = val == "true";
+        } else if (std::dynamic_pointer_cast<ir::IntType>((*arg)->type)) {
+            int64_t value;
+            auto [end, ec] = std::from_chars(val.data(), val.data() + val.size(), value);
+            if (val.empty() || ec != std::errc() || end != val.data() + val.size())
+                throw std::runtime_error("error: invalid argument type, should be int: " + item);
+            known[name] = value;
+        } else {
+            throw std::runtime_error("error: only int and bool arguments can be specialized: " + item);
+        }
+    }
+    return known;
+}
+
+// usage: bril-opt [--call-profile=<file>] [--specialize=<arg>=<value>,...] [pass ...] < prog.json
+// prints the optimized program as text; specialization runs before the passes
+int main(int argc, char **argv) {
+    auto program = ir::parse(std::cin);
+
+    std::vector<std::string> passes;
+    opt::PassOptions options;
+    std::optional<std::unordered_map<std::string, int64_t>> known;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--call-profile=")) {
+            std::ifstream profile(arg.substr(std::string("--call-profile=").size()));
+            opt::ReadCallProfile(*program, profile);
+            options.callProfile = true;
+        } else if (arg.starts_with("--specialize=")) {
+            known = ParseKnownArgs(arg.substr(std::string("--specialize=").size()), *program);
+        } else {
+            passes.push_back(arg);
+        }
+    }
+    if (known) opt::Specialize(*program, *known);
+    opt::RunPasses(*program, passes, options);
+
+    std::cout << *program << std::endl;
+    return 0;
+}
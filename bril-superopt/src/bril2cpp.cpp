@@ -0,0 +1,19 @@
+#include <Codegen/CppEmitter.h>
+#include <IR/Parser.h>
+#include <Transform/Passes.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// usage: bril2cpp [pass ...] < prog.json > prog.cpp
+// then e.g. c++ -std=c++20 -O2 prog.cpp -o prog
+int main(int argc, char **argv) {
+    auto program = ir::parse(std::cin);
+
+    std::vector<std::string> passes(argv + 1, argv + argc);
+    opt::RunPasses(*program, passes);
+
+    codegen::EmitCpp(*program, std::cout);
+    return 0;
+}
@@ -1,14 +1,244 @@
+#include <Analysis/Profile.h>
+#include <Analysis/Purity.h>
+#include <IR/DynCount.h>
 #include <IR/Heap.h>
+#include <IR/Memo.h>
+#include <IR/OpcodePairs.h>
 #include <IR/Parser.h>
+#include <IR/PerfCounters.h>
+#include <IR/Sampler.h>
+#include <IR/Stats.h>
+#include <Trace/Tracer.h>
+#include <Transform/BoundsCheck.h>
+#include <Transform/Fuse.h>
+#include <Transform/Passes.h>
+#ifdef BRIL_HAVE_JIT
+#include <JIT/Jit.h>
+#include <JIT/PerfMap.h>
+#include <JIT/Tiering.h>
+#endif
 
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// counted for --stats; brili allocates from a single thread
+void *operator new(std::size_t size) {
+    if (ir::allocations.counting) {
+        ir::allocations.bytes += size;
+        ir::allocations.count++;
+    }
+    if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
 
 int main(int argc, char **argv) {
-    auto program = ir::parse(std::cin);
+    // options start with "--" (and -p, as in the reference brili), everything
+    // else is an argument of @main
+    std::vector<std::string> passes;
+    std::optional<std::string> profileIn, profileOut, blockProfile, foldedProfile;
+    std::optional<size_t> memoSlots;
+    std::optional<unsigned> sampleHz;
+    bool useJit = false, tiered = false, paranoid = false, fuse = false, pairProfile = false, tracing = false;
+    bool profile = false, histogram = false, perfCounters = false, stats = false;
+    trace::TraceParams traceParams;
+#ifdef BRIL_HAVE_JIT
+    jit::TierParams tierParams;
+    bool perfMap = false, jitdump = false;
+#endif
+    std::vector<char *> mainArgv = {argv[0]};
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-p")
+            profile = true;
+        else if (arg == "--histogram")
+            profile = histogram = true;
+        else if (arg == "--perf-counters")
+            perfCounters = true;
+        else if (arg == "--stats")
+            stats = true;
+        else if (arg == "--sample")
+            sampleHz = 1000;
+        else if (arg.starts_with("--sample="))
+            sampleHz = std::stoul(arg.substr(std::string("--sample=").size()));
+        else if (arg.starts_with("--block-profile="))
+            blockProfile = arg.substr(std::string("--block-profile=").size());
+        else if (arg.starts_with("--folded-profile="))
+            foldedProfile = arg.substr(std::string("--folded-profile=").size());
+        else if (arg.starts_with("--passes="))
+            passes = opt::ParsePassList(arg.substr(std::string("--passes=").size()));
+        else if (arg.starts_with("--call-profile="))
+            profileIn = arg.substr(std::string("--call-profile=").size());
+        else if (arg.starts_with("--call-profile-out="))
+            profileOut = arg.substr(std::string("--call-profile-out=").size());
+        else if (arg == "--memo")
+            memoSlots = 1 << 16;
+        else if (arg.starts_with("--memo="))
+            memoSlots = std::stoull(arg.substr(std::string("--memo=").size()));
+        else if (arg == "--jit")
+            useJit = true;
+        else if (arg == "--tiered")
+            tiered = true;
+        else if (arg == "--paranoid")
+            paranoid = true;
+        else if (arg == "--fuse")
+            fuse = true;
+        else if (arg == "--pair-profile")
+            pairProfile = true;
+        else if (arg == "--trace")
+            tracing = true;
+        else if (arg.starts_with("--trace-loops="))
+            traceParams.loopThreshold = std::stoull(arg.substr(std::string("--trace-loops=").size()));
+        else if (arg.starts_with("--trace-exits="))
+            traceParams.exitThreshold = std::stoull(arg.substr(std::string("--trace-exits=").size()));
+        else if (arg == "--trace-log")
+            traceParams.log = true;
+#ifdef BRIL_HAVE_JIT
+        else if (arg.starts_with("--tier-calls="))
+            tierParams.callThreshold = std::stoull(arg.substr(std::string("--tier-calls=").size()));
+        else if (arg.starts_with("--tier-back-edges="))
+            tierParams.backEdgeThreshold = std::stoull(arg.substr(std::string("--tier-back-edges=").size()));
+        else if (arg == "--tier-log")
+            tierParams.log = true;
+        else if (arg == "--perf-map")
+            perfMap = true;
+        else if (arg == "--jitdump")
+            perfMap = jitdump = true;
+#endif
+        else
+            mainArgv.push_back(argv[i]);
+    }
+
+    // phases run back to back from here to the teardown of the program
+    std::optional<ir::Stats> phases;
+    if (stats) {
+        phases.emplace();
+        ir::allocations.counting = true;
+    }
+    auto program = ir::parse(std::cin, phases ? &*phases : nullptr);
+    if (phases) {
+        phases->count(*program);
+        phases->phase("passes");
+    }
+    opt::PassOptions options;
+    // the profile lists the call sites as parsed, so no pass may change them
+    std::vector<std::shared_ptr<ir::Call>> sites;
+    if (profileOut) sites = opt::CallSites(*program);
+    if (profileIn) {
+        std::ifstream profile(*profileIn);
+        opt::ReadCallProfile(*program, profile);
+        options.callProfile = true;
+    }
+    opt::RunPasses(*program, passes, options);
+    // the bce pass lets accesses proven in bounds skip
+    // HeapManager::boundCheck; it costs more than it saves on short
+    // runs, so it is opt-in, and --paranoid turns every check back on
+    if (paranoid)
+        for (auto& func : program->functions) opt::RestoreBoundsChecks(*func);
+    if (profileOut && opt::CallSites(*program) != sites)
+        throw std::runtime_error("error: --call-profile-out cannot be combined with passes that change call sites");
+    if (fuse)  // superinstructions for the interpreter, last as no pass knows them
+        for (auto& func : program->functions) opt::FuseInstructions(*func);
     auto heap = ir::HeapManager();
-    auto vars = program->SetupVarContext(argc, argv);
+    auto vars = program->SetupVarContext(mainArgv.size(), mainArgv.data());
+    std::optional<ir::MemoTable> memo;
+    if (memoSlots) {  // cache calls of pure functions in the interpreter
+        memo.emplace(*memoSlots);
+        auto pure = opt::PureFunctions(*program);
+        for (auto& func : program->functions)
+            if (pure.contains(func.get())) func->memo = &*memo;
+    }
+    std::optional<ir::OpcodePairs> pairs;
+    if (pairProfile) {
+        pairs.emplace();
+        for (auto& func : program->functions) func->pairs = &*pairs;
+    }
 
-    program->execute(vars, heap);
+    if (profile || blockProfile || foldedProfile || profileOut) {  // blocks are counted by the interpreter only
+        if (useJit || tiered || tracing)
+            throw std::runtime_error("error: -p, block and call profiles cannot be combined with --jit, --tiered or --trace");
+        for (auto& func : program->functions) func->counting = true;
+    }
+#ifdef BRIL_HAVE_JIT
+    if (perfMap && !useJit && !tiered) throw std::runtime_error("error: --perf-map and --jitdump need --jit or --tiered");
+#endif
+    if (tracing && (useJit || tiered)) throw std::runtime_error("error: --trace cannot be combined with --jit or --tiered");
+    if (sampleHz && (useJit || tiered || tracing))
+        throw std::runtime_error("error: --sample cannot be combined with --jit, --tiered or --trace");
+    if (phases) phases->phase("execution");  // compilation included
+    // the interpreter publishes where it is for the SIGPROF handler
+    std::optional<ir::Sampler> sampler;
+    if (sampleHz) {
+        sampler.emplace(*sampleHz);
+        for (auto& func : program->functions) func->sampler = &*sampler;
+    }
+    // counting the execution only: engines are set up and code compiled before start()
+    std::optional<ir::PerfCounters> counters;
+    if (perfCounters) counters.emplace();
+    auto counted = [&](auto&& run) {
+        if (counters) counters->start();
+        run();
+        if (counters) counters->stop();
+    };
+    if (tracing) {
+        trace::TraceEngine engine(*program, traceParams);
+        counted([&] { engine.run(vars, heap); });
+    } else if (useJit || tiered) {
+#ifdef BRIL_HAVE_JIT
+        // named for perf before any code is generated
+        std::optional<jit::PerfMap> perf;
+        if (perfMap) perf.emplace(jitdump);
+        tierParams.perfMap = perf ? &*perf : nullptr;
+        if (tiered) {
+            jit::TieredEngine engine(*program, tierParams);
+            counted([&] { engine.run(vars, heap); });
+        } else {
+            jit::JitEngine engine(*program, tierParams.perfMap);
+            engine.compileAll();
+            counted([&] { engine.run(vars, heap); });
+        }
+#else
+        throw std::runtime_error("error: --jit and --tiered are only supported on x86-64");
+#endif
+    } else
+        counted([&] { program->execute(vars, heap); });
 
+    if (sampler) sampler->stop();
+    if (phases) phases->phase("reports");
+    if (profileOut) {
+        std::ofstream profile(*profileOut);
+        opt::WriteCallProfile(*program, profile);
+    }
+    if (blockProfile) {
+        std::ofstream out(*blockProfile);
+        opt::WriteBlockProfile(*program, out);
+    }
+    if (foldedProfile) {
+        std::ofstream out(*foldedProfile);
+        opt::WriteFoldedProfile(*program, out);
+    }
+    if (profile) {
+        ir::DynCount counts(*program);
+        counts.report(std::cerr);
+        if (histogram) counts.histogram(std::cerr);
+    }
+    if (counters) counters->report(std::cerr);
+    if (sampler) sampler->report(*program, std::cerr);
+    if (memo) memo->report(std::cerr);
+    if (pairs) pairs->report(std::cerr);
+    if (phases) {
+        phases->phase("teardown");
+        vars.clear();
+        program.reset();
+        phases->end();
+        phases->report(std::cerr, heap);
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1 @@
+total_dyn_inst: 6